@@ -36,76 +36,191 @@ void Base58Check::privateKeyToBase58Check(const Uint256 &privKey, char outStr[53
 }
 
 
+size_t Base58Check::encode(const uint8_t version[], size_t versionLen, const uint8_t payload[], size_t payloadLen, char *outStr) {
+	assert((version != nullptr || versionLen == 0) && (payload != nullptr || payloadLen == 0) && outStr != nullptr);
+	assert(versionLen + payloadLen <= MAX_TOTAL_BYTES - 4);
+	uint8_t toEncode[MAX_TOTAL_BYTES];
+	Utils::copyBytes(&toEncode[0], version, versionLen);
+	Utils::copyBytes(&toEncode[versionLen], payload, payloadLen);
+	bytesToBase58Check(toEncode, versionLen + payloadLen, outStr);
+	return strlen(outStr);
+}
+
+
 void Base58Check::bytesToBase58Check(uint8_t *data, size_t dataLen, char *outStr) {
 	// Append 4-byte hash
-	#define MAX_TOTAL_BYTES 38  // Including the 4-byte hash
 	assert(data != nullptr && dataLen <= MAX_TOTAL_BYTES - 4 && outStr != nullptr);
 	const Sha256Hash sha256Hash = Sha256::getDoubleHash(data, dataLen);
 	for (int i = 0; i < 4; i++, dataLen++)
 		data[dataLen] = sha256Hash.value[i];
+	bytesToBase58(data, dataLen, outStr);
+}
+
+
+void Base58Check::bytesToBase58(const uint8_t *data, size_t dataLen, char *outStr) {
+	assert(data != nullptr && dataLen <= MAX_TOTAL_BYTES && outStr != nullptr);
 	
 	// Count leading zero bytes
 	size_t leadingZeros = 0;
 	while (leadingZeros < dataLen && data[leadingZeros] == 0)
 		leadingZeros++;
 	
-	// Encode to Base 58
-	size_t outLen = 0;
-	while (!isZero(data, dataLen)) {  // Extract digits in little-endian
-		outStr[outLen] = ALPHABET[mod58(data, dataLen)];
-		outLen++;
-		uint8_t quotient[MAX_TOTAL_BYTES] = {};
-		divide58(data, quotient, dataLen);  // quotient = floor(data / 58)
-		Utils::copyBytes(data, quotient, dataLen);  // data = quotient
-	}
-	for (size_t i = 0; i < leadingZeros; i++) {  // Append leading zeros
-		outStr[outLen] = ALPHABET[0];
-		outLen++;
+	// Pack the bytes into big-endian 32-bit words, where the first word takes the leftover bytes
+	uint32_t words[(MAX_TOTAL_BYTES + 3) / 4];
+	size_t numWords = (dataLen + 3) / 4;
+	for (size_t i = 0, j = 0; i < numWords; i++) {
+		uint32_t w = 0;
+		for (size_t end = dataLen - (numWords - 1 - i) * 4; j < end; j++)
+			w = (w << 8) | data[j];
+		words[i] = w;
 	}
-	outStr[outLen] = '\0';
 	
-	// Reverse the string
-	if (outLen == 0)
-		return;  // Exit early to ensure that j does not overflow
-	for (size_t i = 0, j = outLen - 1; i < j; i++, j--) {
-		char temp = outStr[i];
-		outStr[i] = outStr[j];
-		outStr[j] = temp;
+	// Divide by 58^5 repeatedly, where each remainder gives 5 digits in little endian.
+	// The dividend's leading words become zero as it shrinks, so they are skipped afterward.
+	const uint32_t RADIX = UINT32_C(656356768);  // 58^5
+	uint8_t digits[MAX_TOTAL_BYTES * 138 / 100 + 5];  // log(256) / log(58) < 1.38
+	size_t numDigits = 0;
+	size_t start = 0;
+	while (start < numWords && words[start] == 0)
+		start++;
+	while (start < numWords) {
+		uint64_t rem = 0;
+		for (size_t i = start; i < numWords; i++) {
+			uint64_t cur = (rem << 32) | words[i];
+			words[i] = static_cast<uint32_t>(cur / RADIX);
+			rem = cur % RADIX;
+		}
+		while (start < numWords && words[start] == 0)
+			start++;
+		for (int i = 0; i < 5; i++, rem /= 58)
+			digits[numDigits++] = static_cast<uint8_t>(rem % 58);
 	}
-	#undef MAX_TOTAL_BYTES
+	while (numDigits > 0 && digits[numDigits - 1] == 0)  // Drop the final chunk's high zero digits
+		numDigits--;
+	
+	// Write the leading zeros, then the digits in big endian
+	size_t outLen = 0;
+	for (size_t i = 0; i < leadingZeros; i++, outLen++)
+		outStr[outLen] = ALPHABET[0];
+	for (size_t i = numDigits; i > 0; i--, outLen++)
+		outStr[outLen] = ALPHABET[digits[i - 1]];
+	outStr[outLen] = '\0';
 }
 
 
-bool Base58Check::isZero(const uint8_t *x, size_t len) {
-	assert(len == 0 || x != nullptr);
-	for (size_t i = 0; i < len; i++) {
-		if (x[i] != 0)
-			return false;
+
+void Base58Check::encodeBatch(const uint8_t pubkeyHashes[], size_t len, char outStrs[][35]) {
+	assert((pubkeyHashes != nullptr && outStrs != nullptr) || len == 0);
+	const size_t PAYLOAD_LEN = 1 + RIPEMD160_HASH_LEN + 4;
+	uint8_t payloads[BATCH_CHUNK][PAYLOAD_LEN];
+	uint8_t checksums[BATCH_CHUNK][4];
+	for (size_t i = 0; i < len; i += BATCH_CHUNK) {
+		size_t n = len - i < BATCH_CHUNK ? len - i : BATCH_CHUNK;
+		for (size_t j = 0; j < n; j++) {
+			payloads[j][0] = 0x00;  // Version byte
+			memcpy(&payloads[j][1], &pubkeyHashes[(i + j) * RIPEMD160_HASH_LEN], RIPEMD160_HASH_LEN);
+		}
+		getChecksums(&payloads[0][0], PAYLOAD_LEN - 4, n, checksums);
+		for (size_t j = 0; j < n; j++)
+			memcpy(&payloads[j][PAYLOAD_LEN - 4], checksums[j], 4);
+		
+		size_t j = 0;
+		for (; j + BATCH_LANES <= n; j += BATCH_LANES) {
+			const uint8_t *data[BATCH_LANES];
+			char *strs[BATCH_LANES];
+			for (int k = 0; k < BATCH_LANES; k++) {
+				data[k] = payloads[j + k];
+				strs[k] = outStrs[i + j + k];
+			}
+			bytesToBase58Lanes(data, PAYLOAD_LEN, strs);
+		}
+		for (; j < n; j++)
+			bytesToBase58(payloads[j], PAYLOAD_LEN, outStrs[i + j]);
 	}
-	return true;
 }
 
 
-uint8_t Base58Check::mod58(const uint8_t *x, size_t len) {
-	assert(len == 0 || x != nullptr);
-	uint_fast16_t sum = 0;
+void Base58Check::getChecksums(const uint8_t data[], size_t dataLen, size_t len, uint8_t outChecksums[][4]) {
+	assert(len <= BATCH_CHUNK);
+	const uint8_t *msgs[BATCH_CHUNK];
+	size_t lens[BATCH_CHUNK];
+	Sha256Hash hashes[BATCH_CHUNK];
+	for (size_t i = 0; i < len; i++) {
+		msgs[i] = &data[i * (dataLen + 4)];
+		lens[i] = dataLen;
+	}
+	Sha256::getHashMulti(msgs, lens, len, hashes);
+	for (size_t i = 0; i < len; i++) {
+		msgs[i] = hashes[i].value;
+		lens[i] = SHA256_HASH_LEN;
+	}
+	Sha256::getHashMulti(msgs, lens, len, hashes);
 	for (size_t i = 0; i < len; i++)
-		sum = ((sum * 24) + x[i]) % 58;  // Note: 256 % 58 = 24
-	return static_cast<uint8_t>(sum);
+		memcpy(outChecksums[i], hashes[i].value, 4);
 }
 
 
-void Base58Check::divide58(const uint8_t *x, uint8_t *y, size_t len) {
-	assert(x != nullptr && y != nullptr);
-	memset(y, 0, len);
-	uint_fast16_t dividend = 0;
-	for (size_t i = 0; i < len * 8; i++) {  // For each output bit
-		dividend = (dividend << 1) | ((x[i >> 3] >> (7 - (i & 7))) & 1);  // Shift next input bit into right side
-		if (dividend >= 58) {
-			dividend -= 58;
-			y[i >> 3] |= 1 << (7 - (i & 7));
+void Base58Check::bytesToBase58Lanes(const uint8_t *const data[], size_t dataLen, char *const outStrs[]) {
+	assert(data != nullptr && dataLen <= MAX_TOTAL_BYTES && outStrs != nullptr);
+	
+	// Pack each input into big-endian 32-bit words, interleaved so that words[i][k] belongs to lane k
+	uint32_t words[(MAX_TOTAL_BYTES + 3) / 4][BATCH_LANES];
+	size_t numWords = (dataLen + 3) / 4;
+	for (int k = 0; k < BATCH_LANES; k++) {
+		for (size_t i = 0, j = 0; i < numWords; i++) {
+			uint32_t w = 0;
+			for (size_t end = dataLen - (numWords - 1 - i) * 4; j < end; j++)
+				w = (w << 8) | data[k][j];
+			words[i][k] = w;
+		}
+	}
+	
+	// Divide all lanes by 58^5 together, skipping the leading words that are zero in every lane
+	const uint32_t RADIX = UINT32_C(656356768);  // 58^5
+	uint8_t digits[MAX_TOTAL_BYTES * 138 / 100 + 5][BATCH_LANES];
+	size_t numDigits = 0;
+	size_t start = 0;
+	while (true) {
+		for (; start < numWords; start++) {
+			uint32_t any = 0;
+			for (int k = 0; k < BATCH_LANES; k++)
+				any |= words[start][k];
+			if (any != 0)
+				break;
+		}
+		if (start >= numWords)
+			break;
+		uint64_t rem[BATCH_LANES] = {};
+		for (size_t i = start; i < numWords; i++) {
+			for (int k = 0; k < BATCH_LANES; k++) {
+				uint64_t cur = (rem[k] << 32) | words[i][k];
+				words[i][k] = static_cast<uint32_t>(cur / RADIX);
+				rem[k] = cur % RADIX;
+			}
+		}
+		for (int i = 0; i < 5; i++, numDigits++) {
+			for (int k = 0; k < BATCH_LANES; k++) {
+				digits[numDigits][k] = static_cast<uint8_t>(rem[k] % 58);
+				rem[k] /= 58;
+			}
 		}
 	}
+	
+	// Write each lane's leading zeros, then its significant digits in big endian
+	for (int k = 0; k < BATCH_LANES; k++) {
+		size_t leadingZeros = 0;
+		while (leadingZeros < dataLen && data[k][leadingZeros] == 0)
+			leadingZeros++;
+		size_t n = numDigits;
+		while (n > 0 && digits[n - 1][k] == 0)
+			n--;
+		char *out = outStrs[k];
+		for (size_t i = 0; i < leadingZeros; i++, out++)
+			*out = ALPHABET[0];
+		for (size_t i = n; i > 0; i--, out++)
+			*out = ALPHABET[digits[i - 1][k]];
+		*out = '\0';
+	}
 }
 
 
@@ -154,20 +269,112 @@ bool Base58Check::privateKeyFromBase58Check(const char wifStr[53], Uint256 &outP
 }
 
 
+bool Base58Check::decode(const char *inStr, uint8_t outVersion[], size_t versionLen, uint8_t outPayload[], size_t payloadLen) {
+	assert(inStr != nullptr && (outVersion != nullptr || versionLen == 0) && (outPayload != nullptr || payloadLen == 0));
+	assert(versionLen + payloadLen <= MAX_TOTAL_BYTES - 4);
+	uint8_t decoded[MAX_TOTAL_BYTES];
+	if (!base58CheckToBytes(inStr, decoded, versionLen + payloadLen + 4))
+		return false;
+	Utils::copyBytes(outVersion, &decoded[0], versionLen);
+	Utils::copyBytes(outPayload, &decoded[versionLen], payloadLen);
+	return true;
+}
+
+
+size_t Base58Check::decodeBatch(const char *const addrStrs[], size_t len, uint8_t outPubkeyHashes[], bool outValid[]) {
+	assert((addrStrs != nullptr && outPubkeyHashes != nullptr && outValid != nullptr) || len == 0);
+	const size_t PAYLOAD_LEN = 1 + RIPEMD160_HASH_LEN + 4;
+	uint8_t payloads[BATCH_CHUNK][PAYLOAD_LEN];
+	uint8_t checksums[BATCH_CHUNK][4];
+	size_t indexes[BATCH_CHUNK];
+	size_t numValid = 0;
+	for (size_t i = 0; i < len; i += BATCH_CHUNK) {
+		size_t n = len - i < BATCH_CHUNK ? len - i : BATCH_CHUNK;
+		
+		// Convert the syntactically valid strings, packing their payloads together
+		size_t m = 0;
+		for (size_t j = 0; j < n; j++) {
+			const char *str = addrStrs[i + j];
+			assert(str != nullptr);
+			outValid[i + j] = false;
+			if (str[0] == '1' && strlen(str) <= 34 && base58ToBytes(str, payloads[m], PAYLOAD_LEN) && payloads[m][0] == 0x00) {
+				indexes[m] = i + j;
+				m++;
+			}
+		}
+		
+		// Check all their hashes at once
+		getChecksums(&payloads[0][0], PAYLOAD_LEN - 4, m, checksums);
+		for (size_t j = 0; j < m; j++) {
+			if (memcmp(checksums[j], &payloads[j][PAYLOAD_LEN - 4], 4) == 0) {
+				memcpy(&outPubkeyHashes[indexes[j] * RIPEMD160_HASH_LEN], &payloads[j][1], RIPEMD160_HASH_LEN);
+				outValid[indexes[j]] = true;
+				numValid++;
+			}
+		}
+	}
+	return numValid;
+}
+
+
 bool Base58Check::base58CheckToBytes(const char *inStr, uint8_t *outData, size_t outDataLen) {
 	assert(inStr != nullptr && outData != nullptr && outDataLen >= 4);
+	if (!base58ToBytes(inStr, outData, outDataLen))
+		return false;
 	
-	// Convert from Base 58 to base 256
-	memset(outData, 0, outDataLen * sizeof(outData[0]));
-	for (size_t i = 0; inStr[i] != '\0'; i++) {
-		if (multiply58(outData, outDataLen))
-			return false;
-		const char *p = strchr(ALPHABET, inStr[i]);
-		if (p == nullptr)
+	// Compute and check hash
+	const Sha256Hash sha256Hash = Sha256::getDoubleHash(outData, outDataLen - 4);
+	for (int i = 0; i < 4; i++) {
+		if (outData[outDataLen - 4 + i] != sha256Hash.value[i])
 			return false;
-		if (addUint8(outData, p - &ALPHABET[0], outDataLen))
+	}
+	return true;
+}
+
+
+bool Base58Check::base58ToBytes(const char *inStr, uint8_t *outData, size_t outDataLen) {
+	assert(inStr != nullptr && outData != nullptr && 1 <= outDataLen && outDataLen <= MAX_TOTAL_BYTES);
+	
+	// Reject bad lengths and characters before doing any arithmetic
+	const size_t maxLen = outDataLen * 138 / 100 + 1;  // log(256) / log(58) < 1.38
+	size_t len = 0;
+	for (; inStr[len] != '\0'; len++) {
+		if (len >= maxLen || DIGIT_VALUES[static_cast<uint8_t>(inStr[len])] == -1)
 			return false;
 	}
+	if (len == 0)
+		return false;
+	
+	// Convert from Base 58 to big-endian 32-bit words, taking up to 5 digits per multiply-add pass
+	uint32_t words[(MAX_TOTAL_BYTES + 3) / 4] = {};
+	size_t numWords = (outDataLen + 3) / 4;
+	for (size_t i = 0; i < len; ) {
+		uint32_t multiplier = 1;
+		uint32_t addend = 0;
+		for (int j = 0; j < 5 && i < len; j++, i++) {
+			multiplier *= 58;
+			addend = addend * 58 + static_cast<uint32_t>(DIGIT_VALUES[static_cast<uint8_t>(inStr[i])]);
+		}
+		uint64_t carry = addend;
+		for (size_t j = numWords; j > 0; j--) {
+			uint64_t cur = static_cast<uint64_t>(words[j - 1]) * multiplier + carry;
+			words[j - 1] = static_cast<uint32_t>(cur);
+			carry = cur >> 32;
+		}
+		if (carry != 0)
+			return false;  // Overflowed the word array
+	}
+	
+	// The top word only has room for the leftover bytes
+	size_t topBytes = outDataLen - (numWords - 1) * 4;
+	if (topBytes < 4 && (words[0] >> (topBytes * 8)) != 0)
+		return false;
+	
+	// Unpack the words to bytes in big endian
+	for (size_t i = 0; i < outDataLen; i++) {
+		size_t k = outDataLen - 1 - i;  // Byte significance
+		outData[i] = static_cast<uint8_t>(words[numWords - 1 - k / 4] >> ((k % 4) * 8));
+	}
 	
 	// Verify number of leading zeros
 	for (size_t i = 0; ; i++) {
@@ -178,50 +385,10 @@ bool Base58Check::base58CheckToBytes(const char *inStr, uint8_t *outData, size_t
 		else
 			return false;  // Mismatch
 	}
-	
-	// Compute and check hash
-	const Sha256Hash sha256Hash = Sha256::getDoubleHash(outData, outDataLen - 4);
-	for (int i = 0; i < 4; i++) {
-		if (outData[outDataLen - 4 + i] != sha256Hash.value[i])
-			return false;
-	}
 	return true;
 }
 
 
-bool Base58Check::addUint8(uint8_t *x, uint8_t y, size_t len) {
-	assert(len >= 1 && x != nullptr);
-	uint_fast16_t carry = 0;
-	for (size_t i = len - 1; ; i--) {
-		uint_fast16_t sum = static_cast<uint_fast16_t>(x[i]) + carry;
-		assert(0 <= sum && sum < 512);
-		if (i == len - 1)
-			sum += y;
-		x[i] = static_cast<uint8_t>(sum);
-		carry = sum >> 8;
-		assert((carry >> 1) == 0);
-		if (i == 0)
-			break;
-	}
-	return carry > 0;
-}
-
-
-bool Base58Check::multiply58(uint8_t *x, size_t len) {
-	assert(len >= 1 && x != nullptr);
-	uint_fast16_t carry = 0;
-	for (size_t i = len - 1; ; i--) {
-		uint_fast16_t temp = static_cast<uint_fast16_t>(x[i]) * 58 + carry;
-		x[i] = static_cast<uint8_t>(temp);
-		carry = temp >> 8;
-		assert(0 <= carry && carry < 58);
-		if (i == 0)
-			break;
-	}
-	return carry > 0;
-}
-
-
 
 /*---- Miscellaneous definitions ----*/
 
@@ -230,3 +397,21 @@ Base58Check::Base58Check() {}
 
 // Static initializers
 const char *Base58Check::ALPHABET = "123456789ABCDEFGHJKLMNPQRSTUVWXYZabcdefghijkmnopqrstuvwxyz";
+const int8_t Base58Check::DIGIT_VALUES[256] = {
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1,  0,  1,  2,  3,  4,  5,  6,  7,  8, -1, -1, -1, -1, -1, -1,
+	-1,  9, 10, 11, 12, 13, 14, 15, 16, -1, 17, 18, 19, 20, 21, -1,
+	22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32, -1, -1, -1, -1, -1,
+	-1, 33, 34, 35, 36, 37, 38, 39, 40, 41, 42, 43, -1, 44, 45, 46,
+	47, 48, 49, 50, 51, 52, 53, 54, 55, 56, 57, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
@@ -8,14 +8,16 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include "Ripemd160.hpp"
 #include "Uint256.hpp"
 
 
 /* 
- * Converts a pubkey hash or a private key into a Base58Check ASCII string.
- * Provides just two static methods.
+ * Converts a pubkey hash or a private key into a Base58Check ASCII string, and back.
+ * Provides just static methods, including batched ones for many addresses at once,
+ * and generic ones for any version prefix (P2SH, testnet, uncompressed WIF, BIP32 extended keys).
  */
 class Base58Check final {
 	
@@ -46,6 +48,33 @@ public:
 	static bool privateKeyFromBase58Check(const char wifStr[53], Uint256 &outPrivKey);
 	
 	
+	// Encodes the given version bytes followed by the given payload as Base58Check text with a null terminator,
+	// writing directly into outStr and returning the text length. Requires versionLen + payloadLen <= 78, which
+	// covers BIP32 extended keys. The outStr array must have length >= (versionLen + payloadLen + 4) * 138 / 100 + 2,
+	// so MAX_STRING_SIZE always suffices. Not constant-time.
+	static size_t encode(const uint8_t version[], size_t versionLen, const uint8_t payload[], size_t payloadLen, char *outStr);
+	
+	
+	// Parses the given Base58Check string, which must decode to exactly versionLen + payloadLen bytes (not counting
+	// the hash). If the syntax and check digits are correct, then the leading versionLen bytes are written to outVersion,
+	// the rest are written to outPayload, and true is returned. The caller checks the version bytes it expects.
+	// Otherwise the output arrays are unchanged and false is returned. Not constant-time.
+	static bool decode(const char *inStr, uint8_t outVersion[], size_t versionLen, uint8_t outPayload[], size_t payloadLen);
+	
+	
+	// Exports each of the len consecutive 20-byte public key hashes as a public address, such that outStrs[i]
+	// is the same as pubkeyHashToBase58Check(&pubkeyHashes[i * 20], ...). The checksums are computed with
+	// multi-buffer SHA-256, and the base conversions of several addresses are interleaved. Not constant-time.
+	static void encodeBatch(const uint8_t pubkeyHashes[], size_t len, char outStrs[][35]);
+	
+	
+	// Parses each of the len public address strings like pubkeyHashFromBase58Check(). For each valid string,
+	// this sets outValid[i] to true and writes the hash to outPubkeyHashes[i * 20 : (i + 1) * 20]; otherwise this
+	// sets outValid[i] to false and leaves that output hash unchanged. Returns the number of valid strings.
+	// The checksums are computed with multi-buffer SHA-256. Not constant-time.
+	static size_t decodeBatch(const char *const addrStrs[], size_t len, uint8_t outPubkeyHashes[], bool outValid[]);
+	
+	
 private:
 	
 	// Computes the 4-byte hash and converts the concatenated data to Base58Check.
@@ -61,29 +90,27 @@ private:
 	static bool base58CheckToBytes(const char *inStr, uint8_t *outData, size_t outDataLen);
 	
 	
-	/* Unsigned big-endian arbitrary-precision arithmetic functions */
-	// Note: This differs from Uint256 because Uint256 is fixed-width, little-endian, and 32-bit-word-oriented.
+	// Converts the given bytes to Base58 text with a null terminator, where each leading zero byte becomes a '1'.
+	// Works on 32-bit words, dividing by 58^5 to get five digits per pass. Requires dataLen <= MAX_TOTAL_BYTES,
+	// and outStr needs room for dataLen * 138 / 100 + 2 characters. Not constant-time.
+	static void bytesToBase58(const uint8_t *data, size_t dataLen, char *outStr);
 	
-	// Tests whether the given bigint is zero. Not constant-time.
-	static bool isZero(const uint8_t *x, size_t len);
 	
+	// Like bytesToBase58(), but converts BATCH_LANES inputs of the same length together. The inputs run their
+	// division passes in lockstep, so the independent divisions overlap instead of waiting on each other.
+	static void bytesToBase58Lanes(const uint8_t *const data[], size_t dataLen, char *const outStrs[]);
 	
-	// Returns the given bigint modulo 58. Not constant-time.
-	static uint8_t mod58(const uint8_t *x, size_t len);
 	
+	// Writes the first 4 bytes of the double SHA-256 hash of each of len <= BATCH_CHUNK payloads. Each payload
+	// is dataLen bytes long and is followed by 4 bytes of room, so consecutive payloads are dataLen + 4 bytes apart.
+	static void getChecksums(const uint8_t data[], size_t dataLen, size_t len, uint8_t outChecksums[][4]);
 	
-	// Computes the quotient y = floor(x / 58). Not constant-time.
-	static void divide58(const uint8_t *x, uint8_t *y, size_t len);
 	
-	
-	// Computes the sum (x = (x + y) mod 256^len) in place. Returns whether the
-	// carry-out is non-zero. Constant-time with respect to x's values and the value of y.
-	static bool addUint8(uint8_t *x, uint8_t y, size_t len);
-	
-	
-	// Computes the product (x = (x * 58) mod 256^len) in place. Returns whether
-	// the carry-out is non-zero. Constant-time with respect to x's values.
-	static bool multiply58(uint8_t *x, size_t len);
+	// Converts the given Base58 string to exactly outDataLen bytes, where each leading '1' must match a leading zero byte.
+	// Returns false, before doing any arithmetic, if the string is empty, too long, or contains a non-Base58 character.
+	// Also returns false if the value doesn't fit. Accumulates up to 5 digits per pass over 32-bit words.
+	// The output array elements may be changed even if false is returned. Not constant-time.
+	static bool base58ToBytes(const char *inStr, uint8_t *outData, size_t outDataLen);
 	
 	
 	Base58Check();  // Not instantiable
@@ -92,7 +119,16 @@ private:
 	
 	/*---- Class constants ----*/
 	
+private:
+	static const size_t MAX_TOTAL_BYTES = 82;  // Longest payload including the 4-byte hash
+	
 public:
 	static const char *ALPHABET;
+	static const size_t MAX_STRING_SIZE = MAX_TOTAL_BYTES * 138 / 100 + 2;  // Including the null terminator
+	
+private:
+	static const int8_t DIGIT_VALUES[256];  // Maps each ASCII character to its Base58 digit value, or -1 if invalid
+	static const int BATCH_LANES = 4;
+	static const size_t BATCH_CHUNK = 64;  // Number of payloads whose checksums are computed together
 	
 };
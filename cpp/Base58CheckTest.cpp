@@ -12,6 +12,7 @@
 #include <cstdio>
 #include <cstdint>
 #include <cstring>
+#include <string>
 #include "Base58Check.hpp"
 #include "Uint256.hpp"
 
@@ -201,6 +202,9 @@ static void testPublicAddressImport() {
 		{false, "0000000000000000000000000000000000000000", "1011112222222222223333333333333333"},
 		{false, "0000000000000000000000000000000000000000", "11111122222I2222223333333333333333"},
 		{false, "0000000000000000000000000000000000000000", "111111222222222222333333*333333333"},
+		{false, "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF", "1QLbz7JHiBTspS962RLKV8GndWFwi5j6Ql"},
+		{false, "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF", "1QLbz7JHiBTspS962RLKV8GndWFwi5j6O"},
+		{false, "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF", "1QLbz7JHiBTspS962RLKV8GndWFwi5j\xC3\xA9"},
 		{false, "0000000000000000000000000000000000000000", "11111122222222222233333333333333333"},
 		{false, "0000000000000000000000000000000000000000", "11RbjxQiHLHWHbqxyAwJDVguxCexXAYMU"},
 		{false, "0000000000000000000000000000000000000000", "115nveGhFfH3HokikNVNixWJccEi6YuH2"},
@@ -697,11 +701,121 @@ static void testPrivateKeyImport() {
 }
 
 
+static void testGenericFormats() {
+	struct GenericCase {
+		const char *version;  // Hexadecimal
+		const char *payload;  // Hexadecimal
+		const char *base58;
+	};
+	GenericCase cases[] = {
+		// P2SH address
+		{"05", "B472A266D0BD89C13706A4132CCFB16F7C3B9FCB", "3J98t1WpEZ73CNmQviecrnyiWrnqRhWNLy"},
+		// Testnet P2PKH and P2SH addresses
+		{"6F", "243F1394F44554F4CE3FD68649C19ADC483CE924", "mipcBbFg9gMiCh81Kj8tqqdgoZub1ZJRfn"},
+		{"C4", "000102030405060708090A0B0C0D0E0F10111213", "2MsFFCK16VhsCcvPXruztdzzcTZEQCbNKjJ"},
+		// Uncompressed WIF, and compressed testnet WIF
+		{"80", "0C28FCA386C7A227600B2FE50B7CAE11EC86D3BF1FBE471BE89827E19D72AA1D", "5HueCGU8rMjxEXxiPuD5BDku4MkFqeZyd4dZ1jvhTVqvbTLvyTJ"},
+		{"EF", "0C28FCA386C7A227600B2FE50B7CAE11EC86D3BF1FBE471BE89827E19D72AA1D01", "cMzLdeGd5vEqxB8B6VFQoRopQ3sLAAvEzDAoQgvX54xwofSWj1fx"},
+		// BIP32 test vector 1 master keys
+		{"0488B21E", "000000000000000000873DFF81C02F525623FD1FE5167EAC3A55A049DE3D314BB42EE227FFED37D5080339A36013301597DAEF41FBE593A02CC513D0B55527EC2DF1050E2E8FF49C85C2",
+			"xpub661MyMwAqRbcFtXgS5sYJABqqG9YLmC4Q1Rdap9gSE8NqtwybGhePY2gZ29ESFjqJoCu1Rupje8YtGqsefD265TMg7usUDFdp6W1EGMcet8"},
+		{"0488ADE4", "000000000000000000873DFF81C02F525623FD1FE5167EAC3A55A049DE3D314BB42EE227FFED37D50800E8F32E723DECF4051AEFAC8E2C93C9C5B214313817CDB01A1494B917C8436B35",
+			"xprv9s21ZrQH143K3QTDL4LXw2F7HEK3wJUD2nW2nRk4stbPy6cq3jPPqjiChkVvvNKmPGJxWUtg6LnF5kejMRNNU3TGtRBeJgk33yuGBxrMPHi"},
+		// Extremes of the longest length
+		{"00000000", "0000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000",
+			"1111111111111111111111111111111111111111111111111111111111111111111111111111114rcJhr"},
+		{"FFFFFFFF", "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF",
+			"wM5uZKgAEWV3d2KFsEasjJ3Byvgres8dt47MCeoDY6ajLJcgrdH74PGchrvUgqMfc6wXGNRPh9zhuCNFJwZqoCkT5P3TaX8j8yrURVdipdiCv8Uh"},
+	};
+	
+	for (unsigned int i = 0; i < ARRAY_LENGTH(cases); i++) {
+		GenericCase &tc = cases[i];
+		Bytes version(hexBytes(tc.version));
+		Bytes payload(hexBytes(tc.payload));
+		char actual[Base58Check::MAX_STRING_SIZE];
+		size_t len = Base58Check::encode(version.data(), version.size(), payload.data(), payload.size(), actual);
+		assert(strcmp(actual, tc.base58) == 0 && len == strlen(tc.base58));
+		
+		Bytes outVersion(version.size());
+		Bytes outPayload(payload.size());
+		assert(Base58Check::decode(tc.base58, outVersion.data(), outVersion.size(), outPayload.data(), outPayload.size()));
+		assert(outVersion == version && outPayload == payload);
+		
+		// Wrong lengths and corrupted check digits must fail without touching the outputs
+		Bytes shorter(payload.size() - 1, 0xA5);
+		assert(!Base58Check::decode(tc.base58, outVersion.data(), outVersion.size(), shorter.data(), shorter.size()));
+		assert(shorter == Bytes(payload.size() - 1, 0xA5));
+		std::string corrupted(tc.base58);
+		char &c = corrupted[corrupted.size() / 2];
+		c = c == 'z' ? 'y' : 'z';
+		assert(!Base58Check::decode(corrupted.c_str(), outVersion.data(), outVersion.size(), outPayload.data(), outPayload.size()));
+		assert(outVersion == version && outPayload == payload);
+		numTestCases++;
+	}
+}
+
+
+static void testBatch() {
+	// Hashes with assorted numbers of leading zero bytes, to exercise every lane's zero handling
+	const size_t MAX_LEN = 150;
+	Bytes hashes(MAX_LEN * 20);
+	static char strs[MAX_LEN][35];
+	static const char *ptrs[MAX_LEN];
+	static uint8_t decoded[MAX_LEN * 20];
+	static bool valid[MAX_LEN];
+	uint32_t seed = 1;
+	for (size_t i = 0; i < hashes.size(); i++) {
+		seed = seed * UINT32_C(1103515245) + 12345;
+		hashes[i] = static_cast<uint8_t>(seed >> 24);
+	}
+	for (size_t i = 0; i < MAX_LEN; i += 3)
+		memset(&hashes[i * 20], 0, i % 21);
+	
+	const char *invalidStrs[] = {
+		"",
+		"1QLbz7JHiBTspS962RLKV8GndWFwi5j6Ql",
+		"1QLbz7JHiBTspS962RLKV8GndWFwi5j6Qs",
+		"11111122222222222233333333333333333",
+		"3J98t1WpEZ73CNmQviecrnyiWrnqRhWNLy",
+		"1BjVpDwZmah1jRHeyqzfsHn1mtv12yzo6MoRgBCS85",
+	};
+	
+	for (size_t len = 0; len <= MAX_LEN; len += (len < 10 ? 1 : 7)) {
+		// Batch encoding must match one-at-a-time encoding
+		Base58Check::encodeBatch(hashes.data(), len, strs);
+		for (size_t i = 0; i < len; i++) {
+			char expect[35];
+			Base58Check::pubkeyHashToBase58Check(&hashes[i * 20], expect);
+			assert(strcmp(strs[i], expect) == 0);
+		}
+		
+		// Mix in invalid strings, then decode them all back
+		for (size_t i = 0; i < len; i++)
+			ptrs[i] = i % 5 == 4 ? invalidStrs[i / 5 % ARRAY_LENGTH(invalidStrs)] : strs[i];
+		size_t numValid = Base58Check::decodeBatch(ptrs, len, decoded, valid);
+		size_t expectValid = 0;
+		for (size_t i = 0; i < len; i++) {
+			uint8_t expect[20];
+			bool ok = Base58Check::pubkeyHashFromBase58Check(ptrs[i], expect);
+			assert(valid[i] == ok && ok == (i % 5 != 4));
+			if (ok) {
+				assert(memcmp(&decoded[i * 20], expect, 20) == 0);
+				expectValid++;
+			}
+		}
+		assert(numValid == expectValid);
+		numTestCases++;
+	}
+}
+
+
 int main(int argc, char **argv) {
 	testPublicAddressExport();
 	testPublicAddressImport();
 	testPrivateKeyExport();
 	testPrivateKeyImport();
+	testGenericFormats();
+	testBatch();
 	printf("All %d test cases passed\n", numTestCases);
 	return 0;
 }
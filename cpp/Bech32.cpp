@@ -0,0 +1,262 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include <cassert>
+#include <cstring>
+#include "Bech32.hpp"
+
+
+/*---- Public functions ----*/
+
+bool Bech32::segwitToBech32(const char *hrp, int witVer, const uint8_t *program, size_t programLen, char outStr[91]) {
+	assert(hrp != nullptr && (program != nullptr || programLen == 0) && outStr != nullptr);
+	size_t hrpLen;
+	uint32_t hrpState;
+	if (!getHrpState(hrp, hrpLen, hrpState) || !isValidProgram(witVer, programLen))
+		return false;
+	return encode(hrp, hrpLen, hrpState, witVer, program, programLen, outStr);
+}
+
+
+bool Bech32::segwitFromBech32(const char *hrp, const char *addrStr,
+		int &outWitVer, uint8_t outProgram[40], size_t &outProgramLen) {
+	assert(hrp != nullptr && addrStr != nullptr && outProgram != nullptr);
+	size_t hrpLen;
+	uint32_t hrpState;
+	if (!getHrpState(hrp, hrpLen, hrpState))
+		return false;
+	return decode(hrp, hrpLen, hrpState, addrStr, outWitVer, outProgram, outProgramLen);
+}
+
+
+bool Bech32::encodeBatch(const char *hrp, int witVer, const uint8_t programs[], size_t programLen,
+		size_t len, char outStrs[][91]) {
+	assert(hrp != nullptr && ((programs != nullptr && outStrs != nullptr) || len == 0));
+	size_t hrpLen;
+	uint32_t hrpState;
+	if (!getHrpState(hrp, hrpLen, hrpState) || !isValidProgram(witVer, programLen)
+			|| hrpLen + 2 + (programLen * 8 + 4) / 5 + 6 > MAX_STRING_LEN)
+		return false;
+	for (size_t i = 0; i < len; i++) {
+		bool ok = encode(hrp, hrpLen, hrpState, witVer, &programs[i * programLen], programLen, outStrs[i]);
+		assert(ok);
+		(void)ok;
+	}
+	return true;
+}
+
+
+size_t Bech32::decodeBatch(const char *hrp, const char *const addrStrs[], size_t len,
+		int outWitVers[], uint8_t outPrograms[][40], size_t outProgramLens[], bool outValid[]) {
+	assert(hrp != nullptr);
+	assert((addrStrs != nullptr && outWitVers != nullptr && outPrograms != nullptr
+		&& outProgramLens != nullptr && outValid != nullptr) || len == 0);
+	size_t hrpLen;
+	uint32_t hrpState;
+	bool hrpOk = getHrpState(hrp, hrpLen, hrpState);
+	size_t numValid = 0;
+	for (size_t i = 0; i < len; i++) {
+		assert(addrStrs[i] != nullptr);
+		outValid[i] = hrpOk && decode(hrp, hrpLen, hrpState, addrStrs[i], outWitVers[i], outPrograms[i], outProgramLens[i]);
+		if (outValid[i])
+			numValid++;
+	}
+	return numValid;
+}
+
+
+
+/*---- Private functions ----*/
+
+bool Bech32::getHrpState(const char *hrp, size_t &outLen, uint32_t &outState) {
+	size_t len = 0;
+	for (; hrp[len] != '\0'; len++) {
+		char c = hrp[len];
+		if (len >= 83 || c < 33 || c > 126 || (c >= 'A' && c <= 'Z'))
+			return false;
+	}
+	if (len == 0)
+		return false;
+	
+	// Absorb the high bits of each character, a zero separator, then the low bits of each character
+	uint32_t state = 1;
+	for (size_t i = 0; i < len; i++)
+		state = polymodStep(state, static_cast<uint8_t>(hrp[i]) >> 5);
+	state = polymodStep(state, 0);
+	for (size_t i = 0; i < len; i++)
+		state = polymodStep(state, static_cast<uint8_t>(hrp[i]) & 31);
+	outLen = len;
+	outState = state;
+	return true;
+}
+
+
+bool Bech32::isValidProgram(int witVer, size_t programLen) {
+	if (witVer < 0 || witVer > 16 || programLen < 2 || programLen > MAX_PROGRAM_LEN)
+		return false;
+	return witVer != 0 || programLen == 20 || programLen == 32;
+}
+
+
+bool Bech32::encode(const char *hrp, size_t hrpLen, uint32_t hrpState,
+		int witVer, const uint8_t *program, size_t programLen, char *outStr) {
+	
+	// Regroup the program from 8-bit bytes into 5-bit values, zero-padding the last one
+	uint8_t values[1 + (MAX_PROGRAM_LEN * 8 + 4) / 5];
+	size_t numValues = 0;
+	values[numValues] = static_cast<uint8_t>(witVer);
+	numValues++;
+	uint32_t acc = 0;
+	int bits = 0;
+	for (size_t i = 0; i < programLen; i++) {
+		acc = (acc << 8) | program[i];
+		for (bits += 8; bits >= 5; numValues++) {
+			bits -= 5;
+			values[numValues] = static_cast<uint8_t>((acc >> bits) & 31);
+		}
+	}
+	if (bits > 0) {
+		values[numValues] = static_cast<uint8_t>((acc << (5 - bits)) & 31);
+		numValues++;
+	}
+	if (hrpLen + 1 + numValues + 6 > MAX_STRING_LEN)
+		return false;
+	
+	// Write the HRP, separator and data characters, then the checksum of 6 values
+	uint32_t state = hrpState;
+	memcpy(outStr, hrp, hrpLen);
+	char *out = &outStr[hrpLen];
+	*out = '1';
+	out++;
+	for (size_t i = 0; i < numValues; i++, out++) {
+		state = polymodStep(state, values[i]);
+		*out = CHARSET[values[i]];
+	}
+	for (int i = 0; i < 6; i++)
+		state = polymodStep(state, 0);
+	state ^= getChecksumConst(witVer);
+	for (int i = 0; i < 6; i++, out++)
+		*out = CHARSET[(state >> ((5 - i) * 5)) & 31];
+	*out = '\0';
+	return true;
+}
+
+
+bool Bech32::decode(const char *hrp, size_t hrpLen, uint32_t hrpState, const char *addrStr,
+		int &outWitVer, uint8_t outProgram[40], size_t &outProgramLen) {
+	
+	// Match the HRP and separator, disallowing mixed case anywhere in the string
+	bool hasLower = false;
+	bool hasUpper = false;
+	for (size_t i = 0; i < hrpLen; i++) {
+		char c = addrStr[i];
+		if (c >= 'A' && c <= 'Z') {
+			hasUpper = true;
+			c = static_cast<char>(c - 'A' + 'a');
+		} else if (c >= 'a' && c <= 'z')
+			hasLower = true;
+		if (c != hrp[i])
+			return false;  // Also catches the string being shorter than the HRP
+	}
+	if (addrStr[hrpLen] != '1')
+		return false;
+	
+	// Parse the data characters, keeping at most 5-bit values of a witness version and a 40-byte program
+	uint8_t values[MAX_STRING_LEN];
+	size_t numValues = 0;
+	uint32_t state = hrpState;
+	for (const char *p = &addrStr[hrpLen + 1]; *p != '\0'; p++, numValues++) {
+		char c = *p;
+		int8_t val = DIGIT_VALUES[static_cast<uint8_t>(c)];
+		if (val == -1 || hrpLen + 1 + numValues >= MAX_STRING_LEN)
+			return false;
+		if (c >= 'A' && c <= 'Z')
+			hasUpper = true;
+		else if (c >= 'a' && c <= 'z')
+			hasLower = true;
+		values[numValues] = static_cast<uint8_t>(val);
+		state = polymodStep(state, static_cast<uint32_t>(val));
+	}
+	if ((hasLower && hasUpper) || numValues < 1 + 6)
+		return false;
+	
+	// Check the witness version and its checksum variant
+	int witVer = values[0];
+	if (witVer > 16 || state != getChecksumConst(witVer))
+		return false;
+	
+	// Regroup the 5-bit values into bytes, allowing at most 4 bits of zero padding
+	uint8_t program[MAX_PROGRAM_LEN];
+	size_t programLen = 0;
+	uint32_t acc = 0;
+	int bits = 0;
+	for (size_t i = 1; i < numValues - 6; i++) {
+		acc = ((acc << 5) | values[i]) & 0xFFF;
+		bits += 5;
+		if (bits >= 8) {
+			bits -= 8;
+			if (programLen >= MAX_PROGRAM_LEN)
+				return false;
+			program[programLen] = static_cast<uint8_t>(acc >> bits);
+			programLen++;
+		}
+	}
+	if (bits >= 5 || (acc & ((1U << bits) - 1)) != 0 || !isValidProgram(witVer, programLen))
+		return false;
+	
+	// Successfully set the outputs
+	outWitVer = witVer;
+	memcpy(outProgram, program, programLen);
+	outProgramLen = programLen;
+	return true;
+}
+
+
+uint32_t Bech32::getChecksumConst(int witVer) {
+	if (witVer == 0)
+		return BECH32_CONST;
+	else
+		return BECH32M_CONST;
+}
+
+
+uint32_t Bech32::polymodStep(uint32_t state, uint32_t value) {
+	return ((state & UINT32_C(0x1FFFFFF)) << 5) ^ value ^ GENERATOR_TABLE[state >> 25];
+}
+
+
+// Static initializers
+const char *Bech32::CHARSET = "qpzry9x8gf2tvdw0s3jn54khce6mua7l";
+const uint32_t Bech32::GENERATOR_TABLE[32] = {
+	UINT32_C(0x00000000), UINT32_C(0x3B6A57B2), UINT32_C(0x26508E6D), UINT32_C(0x1D3AD9DF),
+	UINT32_C(0x1EA119FA), UINT32_C(0x25CB4E48), UINT32_C(0x38F19797), UINT32_C(0x039BC025),
+	UINT32_C(0x3D4233DD), UINT32_C(0x0628646F), UINT32_C(0x1B12BDB0), UINT32_C(0x2078EA02),
+	UINT32_C(0x23E32A27), UINT32_C(0x18897D95), UINT32_C(0x05B3A44A), UINT32_C(0x3ED9F3F8),
+	UINT32_C(0x2A1462B3), UINT32_C(0x117E3501), UINT32_C(0x0C44ECDE), UINT32_C(0x372EBB6C),
+	UINT32_C(0x34B57B49), UINT32_C(0x0FDF2CFB), UINT32_C(0x12E5F524), UINT32_C(0x298FA296),
+	UINT32_C(0x1756516E), UINT32_C(0x2C3C06DC), UINT32_C(0x3106DF03), UINT32_C(0x0A6C88B1),
+	UINT32_C(0x09F74894), UINT32_C(0x329D1F26), UINT32_C(0x2FA7C6F9), UINT32_C(0x14CD914B),
+};
+const int8_t Bech32::DIGIT_VALUES[256] = {
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	15, -1, 10, 17, 21, 20, 26, 30,  7,  5, -1, -1, -1, -1, -1, -1,
+	-1, 29, -1, 24, 13, 25,  9,  8, 23, -1, 18, 22, 31, 27, 19, -1,
+	 1,  0,  3, 16, 11, 28, 12, 14,  6,  4,  2, -1, -1, -1, -1, -1,
+	-1, 29, -1, 24, 13, 25,  9,  8, 23, -1, 18, 22, 31, 27, 19, -1,
+	 1,  0,  3, 16, 11, 28, 12, 14,  6,  4,  2, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+	-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+};
@@ -0,0 +1,103 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+
+/* 
+ * Converts a SegWit witness program into a Bech32 (BIP 173) or Bech32m (BIP 350) address string, and back.
+ * Witness version 0 (P2WPKH, P2WSH) uses Bech32, and versions 1 to 16 (such as Taproot) use Bech32m.
+ * Provides just static methods, including batched ones for many addresses with the same human-readable part.
+ */
+class Bech32 final {
+	
+public:
+	
+	// Exports the given witness program as an address with the given human-readable part (such as "bc" or "tb"),
+	// which must be lowercase. The outStr array must have length >= 91 (including null terminator). Returns true
+	// if successful. Returns false and leaves outStr unchanged if the HRP is invalid, the witness version is outside
+	// [0, 16], the program length is invalid for the version, or the address would exceed 90 characters. Not constant-time.
+	static bool segwitToBech32(const char *hrp, int witVer, const uint8_t *program, size_t programLen, char outStr[91]);
+	
+	
+	// Parses the given address string, whose human-readable part must match the given lowercase HRP (the address
+	// itself may be all uppercase). If the syntax, checksum variant, check digits, witness version and program length
+	// are all correct, then the outputs are set and true is returned. Otherwise the outputs are unchanged
+	// and false is returned. Not constant-time.
+	static bool segwitFromBech32(const char *hrp, const char *addrStr,
+		int &outWitVer, uint8_t outProgram[40], size_t &outProgramLen);
+	
+	
+	// Exports each of the len consecutive witness programs, all programLen bytes long and of the same version,
+	// such that outStrs[i] is the same as segwitToBech32(hrp, witVer, &programs[i * programLen], ...).
+	// The checksum state of the HRP is computed only once. Returns false and changes nothing
+	// if segwitToBech32() would return false for these arguments. Not constant-time.
+	static bool encodeBatch(const char *hrp, int witVer, const uint8_t programs[], size_t programLen,
+		size_t len, char outStrs[][91]);
+	
+	
+	// Parses each of the len address strings like segwitFromBech32(). For each valid string, this sets outValid[i]
+	// to true and sets outWitVers[i], outPrograms[i] and outProgramLens[i]; otherwise this sets outValid[i] to false
+	// and leaves the other outputs for that index unchanged. Returns the number of valid strings.
+	// The checksum state of the HRP is computed only once. Not constant-time.
+	static size_t decodeBatch(const char *hrp, const char *const addrStrs[], size_t len,
+		int outWitVers[], uint8_t outPrograms[][40], size_t outProgramLens[], bool outValid[]);
+	
+	
+private:
+	
+	// Checks that the given HRP is 1 to 83 printable lowercase ASCII characters, and if so sets
+	// its length and the checksum state after absorbing its expansion, and returns true.
+	static bool getHrpState(const char *hrp, size_t &outLen, uint32_t &outState);
+	
+	
+	// Tests whether the given witness version and program length are allowed by BIP 141.
+	static bool isValidProgram(int witVer, size_t programLen);
+	
+	
+	// Writes the address for an HRP that already passed getHrpState(), and a program that passed isValidProgram().
+	// Returns false if the address would be too long.
+	static bool encode(const char *hrp, size_t hrpLen, uint32_t hrpState,
+		int witVer, const uint8_t *program, size_t programLen, char *outStr);
+	
+	
+	// Parses an address against an HRP that already passed getHrpState(). The outputs may be
+	// changed only if true is returned.
+	static bool decode(const char *hrp, size_t hrpLen, uint32_t hrpState, const char *addrStr,
+		int &outWitVer, uint8_t outProgram[40], size_t &outProgramLen);
+	
+	
+	// Returns the value that the checksum state is XORed with: Bech32 for witness version 0, otherwise Bech32m.
+	static uint32_t getChecksumConst(int witVer);
+	
+	
+	// Absorbs one 5-bit value into the BCH checksum state, using a table instead of a loop over generator bits.
+	static uint32_t polymodStep(uint32_t state, uint32_t value);
+	
+	
+	Bech32();  // Not instantiable
+	
+	
+	
+	/*---- Class constants ----*/
+	
+public:
+	static const char *CHARSET;
+	static const size_t MAX_STRING_LEN = 90;  // Excluding the null terminator
+	static const size_t MAX_PROGRAM_LEN = 40;
+	
+private:
+	static const uint32_t BECH32_CONST = 1;
+	static const uint32_t BECH32M_CONST = UINT32_C(0x2BC830A3);
+	static const uint32_t GENERATOR_TABLE[32];  // XOR of the generators selected by each 5-bit overflow value
+	static const int8_t DIGIT_VALUES[256];  // Maps each ASCII character to its value in either case, or -1 if invalid
+	
+};
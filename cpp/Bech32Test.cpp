@@ -0,0 +1,183 @@
+/* 
+ * A runnable main program that tests the functionality of class Bech32.
+ * 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include "TestHelper.hpp"
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include "Bech32.hpp"
+
+
+/*---- Structures ----*/
+
+struct ValidCase {
+	const char *hrp;
+	int witVer;
+	const char *program;  // Hexadecimal
+	const char *address;
+};
+
+
+// Global variables
+static int numTestCases = 0;
+
+
+/*---- Test suite ----*/
+
+static void testValidAddresses() {
+	// From BIP 173 and BIP 350
+	ValidCase cases[] = {
+		{"bc", 0, "751E76E8199196D454941C45D1B3A323F1433BD6", "BC1QW508D6QEJXTDG4Y5R3ZARVARY0C5XW7KV8F3T4"},
+		{"tb", 0, "1863143C14C5166804BD19203356DA136C985678CD4D27A1B8C6329604903262", "tb1qrp33g0q5c5txsp9arysrx4k6zdkfs4nce4xj0gdcccefvpysxf3q0sl5k7"},
+		{"bc", 1, "751E76E8199196D454941C45D1B3A323F1433BD6751E76E8199196D454941C45D1B3A323F1433BD6", "bc1pw508d6qejxtdg4y5r3zarvary0c5xw7kw508d6qejxtdg4y5r3zarvary0c5xw7kt5nd6y"},
+		{"bc", 16, "751E", "BC1SW50QGDZ25J"},
+		{"bc", 2, "751E76E8199196D454941C45D1B3A323", "bc1zw508d6qejxtdg4y5r3zarvaryvaxxpcs"},
+		{"tb", 0, "000000C4A5CAD46221B2A187905E5266362B99D5E91C6CE24D165DAB93E86433", "tb1qqqqqp399et2xygdj5xreqhjjvcmzhxw4aywxecjdzew6hylgvsesrxh6hy"},
+		{"tb", 1, "000000C4A5CAD46221B2A187905E5266362B99D5E91C6CE24D165DAB93E86433", "tb1pqqqqp399et2xygdj5xreqhjjvcmzhxw4aywxecjdzew6hylgvsesf3hn0c"},
+		{"bc", 1, "79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798", "bc1p0xlxvlhemja6c4dqv22uapctqupfhlxm9h8z3k2e72q4k9hcz7vqzk5jj0"},
+	};
+	
+	for (unsigned int i = 0; i < ARRAY_LENGTH(cases); i++) {
+		ValidCase &tc = cases[i];
+		Bytes program(hexBytes(tc.program));
+		int witVer = -1;
+		uint8_t actual[40];
+		size_t actualLen = 0;
+		assert(Bech32::segwitFromBech32(tc.hrp, tc.address, witVer, actual, actualLen));
+		assert(witVer == tc.witVer && Bytes(actual, actual + actualLen) == program);
+		
+		// Encoding always produces lowercase
+		char str[91];
+		assert(Bech32::segwitToBech32(tc.hrp, tc.witVer, program.data(), program.size(), str));
+		std::string expect(tc.address);
+		for (char &c : expect) {
+			if (c >= 'A' && c <= 'Z')
+				c = static_cast<char>(c - 'A' + 'a');
+		}
+		assert(expect == str);
+		numTestCases++;
+	}
+}
+
+
+static void testInvalidAddresses() {
+	// From BIP 173 and BIP 350, plus some syntax errors
+	const char *cases[][2] = {
+		{"bc", "tc1p0xlxvlhemja6c4dqv22uapctqupfhlxm9h8z3k2e72q4k9hcz7vq5zuyut"},  // Wrong HRP
+		{"bc", "bc1p0xlxvlhemja6c4dqv22uapctqupfhlxm9h8z3k2e72q4k9hcz7vqh2y7hd"},  // Bech32 instead of Bech32m
+		{"tb", "tb1z0xlxvlhemja6c4dqv22uapctqupfhlxm9h8z3k2e72q4k9hcz7vqglt7rf"},
+		{"bc", "BC1S0XLXVLHEMJA6C4DQV22UAPCTQUPFHLXM9H8Z3K2E72Q4K9HCZ7VQ54WELL"},
+		{"bc", "bc1qw508d6qejxtdg4y5r3zarvary0c5xw7kemeawh"},  // Bech32m instead of Bech32
+		{"tb", "tb1q0xlxvlhemja6c4dqv22uapctqupfhlxm9h8z3k2e72q4k9hcz7vq24jc47"},
+		{"bc", "bc1p38j9r5y49hruaue7wxjce0updqjuyyx0kh56v8s25huc6995vvpql3jow4"},  // Invalid character
+		{"bc", "BC130XLXVLHEMJA6C4DQV22UAPCTQUPFHLXM9H8Z3K2E72Q4K9HCZ7VQ7ZWS8R"},  // Witness version 17
+		{"bc", "bc1pw5dgrnzv"},  // Program too short
+		{"bc", "bc1p0xlxvlhemja6c4dqv22uapctqupfhlxm9h8z3k2e72q4k9hcz7v8n0nx0muaewav253zgeav"},  // Program too long
+		{"bc", "BC1QR508D6QEJXTDG4Y5R3ZARVARYV98GJ9P"},  // Wrong program length for version 0
+		{"tb", "tb1p0xlxvlhemja6c4dqv22uapctqupfhlxm9h8z3k2e72q4k9hcz7vq47Zagq"},  // Mixed case
+		{"bc", "bc1p0xlxvlhemja6c4dqv22uapctqupfhlxm9h8z3k2e72q4k9hcz7v07qwwzcrf"},  // Padding more than 4 bits
+		{"tb", "tb1p0xlxvlhemja6c4dqv22uapctqupfhlxm9h8z3k2e72q4k9hcz7vpggkg4j"},  // Nonzero padding
+		{"bc", "bc1gmk9yu"},  // Empty data
+		{"bc", ""},
+		{"bc", "bc"},
+		{"bc", "b"},
+		{"bc", "bc1"},
+		{"bc", "bcq1w508d6qejxtdg4y5r3zarvary0c5xw7kv8f3t4"},
+		{"bc", "bc1qw508d6qejxtdg4y5r3zarvary0c5xw7kv8f3t5"},  // Bad check digit
+		{"bc", "bc1qw508d6qejxtdg4y5r3zarvary0c5xw7kv8f3t4 "},
+		{"bc", "bc1qw508d6qejxtdg4y5r3zarvary0c5xw7kv8f3t\xC3\xA9"},
+		{"Bc", "bc1qw508d6qejxtdg4y5r3zarvary0c5xw7kv8f3t4"},  // Uppercase HRP argument
+		{"", "1qw508d6qejxtdg4y5r3zarvary0c5xw7kv8f3t4"},
+	};
+	
+	for (unsigned int i = 0; i < ARRAY_LENGTH(cases); i++) {
+		int witVer = -1;
+		uint8_t program[40] = {};
+		size_t programLen = 99;
+		assert(!Bech32::segwitFromBech32(cases[i][0], cases[i][1], witVer, program, programLen));
+		assert(witVer == -1 && programLen == 99);
+		numTestCases++;
+	}
+}
+
+
+static void testInvalidEncodes() {
+	uint8_t program[41] = {};
+	char str[91];
+	assert(!Bech32::segwitToBech32("bc", -1, program, 20, str));
+	assert(!Bech32::segwitToBech32("bc", 17, program, 32, str));
+	assert(!Bech32::segwitToBech32("bc", 0, program, 21, str));
+	assert(!Bech32::segwitToBech32("bc", 1, program, 1, str));
+	assert(!Bech32::segwitToBech32("bc", 1, program, 41, str));
+	assert(!Bech32::segwitToBech32("BC", 0, program, 20, str));
+	assert(!Bech32::segwitToBech32("", 0, program, 20, str));
+	assert(!Bech32::segwitToBech32("b c", 0, program, 20, str));
+	assert( Bech32::segwitToBech32("abcdefghijklmnopqr", 1, program, 40, str));  // 90 characters
+	assert(strlen(str) == 90);
+	assert(!Bech32::segwitToBech32("abcdefghijklmnopqrs", 1, program, 40, str));  // 91 characters
+	assert(!Bech32::encodeBatch("abcdefghijklmnopqrs", 1, program, 40, 1, &str));
+	numTestCases += 11;
+}
+
+
+static void testBatch() {
+	const size_t MAX_LEN = 40;
+	Bytes programs(MAX_LEN * 32);
+	uint32_t seed = 1;
+	for (size_t i = 0; i < programs.size(); i++) {
+		seed = seed * UINT32_C(1103515245) + 12345;
+		programs[i] = static_cast<uint8_t>(seed >> 24);
+	}
+	static char strs[MAX_LEN][91];
+	static const char *ptrs[MAX_LEN];
+	static int witVers[MAX_LEN];
+	static uint8_t decoded[MAX_LEN][40];
+	static size_t decodedLens[MAX_LEN];
+	static bool valid[MAX_LEN];
+	
+	const int WIT_VERS[] = {0, 1, 0};
+	const size_t PROGRAM_LENS[] = {20, 32, 32};
+	for (int i = 0; i < 3; i++) {
+		int witVer = WIT_VERS[i];
+		size_t programLen = PROGRAM_LENS[i];
+		assert(Bech32::encodeBatch("bc", witVer, programs.data(), programLen, MAX_LEN, strs));
+		for (size_t j = 0; j < MAX_LEN; j++) {
+			char expect[91];
+			assert(Bech32::segwitToBech32("bc", witVer, &programs[j * programLen], programLen, expect));
+			assert(strcmp(strs[j], expect) == 0);
+			ptrs[j] = strs[j];
+		}
+		
+		// Corrupt every third address, then decode them all back
+		for (size_t j = 0; j < MAX_LEN; j += 3)
+			strs[j][10] = strs[j][10] == 'q' ? 'p' : 'q';
+		size_t numValid = Bech32::decodeBatch("bc", ptrs, MAX_LEN, witVers, decoded, decodedLens, valid);
+		assert(numValid == MAX_LEN - (MAX_LEN + 2) / 3);
+		for (size_t j = 0; j < MAX_LEN; j++) {
+			assert(valid[j] == (j % 3 != 0));
+			if (valid[j]) {
+				assert(witVers[j] == witVer && decodedLens[j] == programLen);
+				assert(memcmp(decoded[j], &programs[j * programLen], programLen) == 0);
+			}
+		}
+		numTestCases++;
+	}
+}
+
+
+int main(int argc, char **argv) {
+	testValidAddresses();
+	testInvalidAddresses();
+	testInvalidEncodes();
+	testBatch();
+	printf("All %d test cases passed\n", numTestCases);
+	return 0;
+}
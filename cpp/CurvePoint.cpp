@@ -7,6 +7,7 @@
  */
 
 #include <cassert>
+#include <vector>
 #include "CurvePoint.hpp"
 
 
@@ -165,29 +166,8 @@ void CurvePoint::twice() {
 
 
 void CurvePoint::multiply(const Uint256 &n) {
-	// Precompute [this*0, this*1, ..., this*15]
-	CurvePoint table[16];  // Default-initialized with ZERO
-	table[1] = *this;
-	table[2] = *this;
-	table[2].twice();
-	for (int i = 3; i < 16; i++) {
-		table[i] = table[i - 1];
-		table[i].add(*this);
-	}
-	
-	// Process 4 bits per iteration (windowed method)
-	*this = ZERO;
-	for (int i = 256 - 4; i >= 0; i -= 4) {
-		unsigned int inc = (n.value[i >> 5] >> (i & 31)) & 15;
-		CurvePoint q(ZERO);
-		for (unsigned int j = 0; j < 16; j++)
-			q.replace(table[j], static_cast<uint32_t>(j == inc));
-		this->add(q);
-		if (i != 0) {
-			for (int j = 0; j < 4; j++)
-				this->twice();
-		}
-	}
+	const MultiplesTable table(*this);
+	*this = table.multiply(n);
 }
 
 
@@ -256,15 +236,163 @@ void CurvePoint::toCompressedPoint(uint8_t output[33]) const {
 }
 
 
+bool CurvePoint::fromCompressedPoint(const uint8_t input[33], CurvePoint &outPoint) {
+	assert(input != nullptr);
+	if (input[0] != 0x02 && input[0] != 0x03)
+		return false;
+	const Uint256 xVal(&input[1]);
+	const FieldInt x(xVal);
+	if (Uint256(x) != xVal)
+		return false;  // Not reduced
+	
+	// Compute the candidate y = (x^3 + 7)^((p + 1) / 4), which squares back to x^3 + 7 iff a root exists
+	FieldInt ySquared(x);
+	ySquared.square();
+	ySquared.add(A);
+	ySquared.multiply(x);
+	ySquared.add(B);
+	FieldInt y(FI_ONE);
+	for (int i = 255; i >= 0; i--) {
+		y.square();
+		if (((SQRT_EXPONENT.value[i >> 5] >> (i & 31)) & 1) != 0)
+			y.multiply(ySquared);
+	}
+	FieldInt check(y);
+	check.square();
+	if (check != ySquared)
+		return false;
+	
+	// Pick the root whose parity matches the header byte
+	if ((y.value[0] & 1) != (input[0] & 1U)) {
+		FieldInt negY(FI_ZERO);
+		negY.subtract(y);
+		y = negY;
+	}
+	outPoint = CurvePoint(x, y);
+	return true;
+}
+
+
+void CurvePoint::normalizeAll(CurvePoint points[], size_t len) {
+	/* 
+	 * Montgomery's trick: Invert the product of all the z values at once, then peel off each individual
+	 * reciprocal. Zero points have z = 0, so their z is substituted by 1 to keep the product invertible.
+	 */
+	assert(points != nullptr || len == 0);
+	const size_t CHUNK = 32;
+	for (size_t off = 0; off < len; off += CHUNK) {
+		size_t n = len - off < CHUNK ? len - off : CHUNK;
+		CurvePoint *pts = &points[off];
+		
+		// prefix[i] = z[0] * z[1] * ... * z[i - 1], with the substitution
+		Uint256 prefix[CHUNK];
+		FieldInt product(FI_ONE);
+		for (size_t i = 0; i < n; i++) {
+			prefix[i] = Uint256(product);
+			FieldInt z(pts[i].z);
+			z.replace(FI_ONE, static_cast<uint32_t>(z == FI_ZERO));
+			product.multiply(z);
+		}
+		
+		product.reciprocal();  // Now the inverse of all the z values
+		for (size_t i = n; i-- > 0; ) {
+			CurvePoint &p = pts[i];
+			FieldInt z(p.z);
+			uint32_t isZ0 = static_cast<uint32_t>(z == FI_ZERO);
+			z.replace(FI_ONE, isZ0);
+			FieldInt zInv(prefix[i]);
+			zInv.multiply(product);
+			product.multiply(z);
+			
+			CurvePoint norm(p);
+			norm.x.multiply(zInv);
+			norm.y.multiply(zInv);
+			norm.z = FI_ONE;
+			p.x.replace(FI_ONE, static_cast<uint32_t>(p.x != FI_ZERO));
+			p.y.replace(FI_ONE, static_cast<uint32_t>(p.y != FI_ZERO));
+			p.replace(norm, isZ0 ^ 1);
+		}
+	}
+}
+
+
+CurvePoint CurvePoint::multiplyBasePoint(const Uint256 &n) {
+	// Add one table entry per 4-bit digit: n * G = sum of (digit[i] * 16^i * G)
+	const MultiplesTable *tables = getBasePointTables();
+	CurvePoint result(ZERO);
+	for (int i = 0; i < 64; i++) {
+		unsigned int inc = (n.value[i >> 3] >> ((i & 7) << 2)) & 15;
+		CurvePoint q(ZERO);
+		for (unsigned int j = 0; j < 16; j++)
+			q.replace(tables[i].points[j], static_cast<uint32_t>(j == inc));
+		result.add(q);
+	}
+	return result;
+}
+
+
 CurvePoint CurvePoint::privateExponentToPublicPoint(const Uint256 &privExp) {
 	assert((Uint256::ZERO < privExp) & (privExp < CurvePoint::ORDER));
-	CurvePoint result(CurvePoint::G);
-	result.multiply(privExp);
+	CurvePoint result(multiplyBasePoint(privExp));
 	result.normalize();
 	return result;
 }
 
 
+const CurvePoint::MultiplesTable *CurvePoint::getBasePointTables() {
+	struct Builder final {
+		std::vector<MultiplesTable> tables;
+		Builder() {
+			CurvePoint base(G);
+			for (int i = 0; i < 64; i++) {
+				tables.push_back(MultiplesTable(base));
+				tables.back().normalize();
+				for (int j = 0; j < 4; j++)
+					base.twice();
+			}
+		}
+	};
+	static const Builder builder;  // Thread-safe initialization since C++11
+	return builder.tables.data();
+}
+
+
+CurvePoint::MultiplesTable::MultiplesTable(const CurvePoint &p) {
+	// Precompute [p*0, p*1, ..., p*15]
+	// (points[0] is default-initialized with ZERO)
+	points[1] = p;
+	points[2] = p;
+	points[2].twice();
+	for (int i = 3; i < 16; i++) {
+		points[i] = points[i - 1];
+		points[i].add(p);
+	}
+}
+
+
+void CurvePoint::MultiplesTable::normalize() {
+	normalizeAll(points, 16);
+}
+
+
+CurvePoint CurvePoint::MultiplesTable::multiply(const Uint256 &n) const {
+	// Process 4 bits per iteration (windowed method)
+	CurvePoint result(ZERO);
+	for (int i = 256 - 4; i >= 0; i -= 4) {
+		unsigned int inc = (n.value[i >> 5] >> (i & 31)) & 15;
+		CurvePoint q(ZERO);
+		for (unsigned int j = 0; j < 16; j++)
+			q.replace(points[j], static_cast<uint32_t>(j == inc));
+		result.add(q);
+		if (i != 0) {
+			for (int j = 0; j < 4; j++)
+				result.twice();
+		}
+	}
+	return result;
+}
+
+
 // Static initializers
 const FieldInt CurvePoint::FI_ZERO("0000000000000000000000000000000000000000000000000000000000000000");
 const FieldInt CurvePoint::FI_ONE ("0000000000000000000000000000000000000000000000000000000000000001");
@@ -275,3 +403,4 @@ const CurvePoint CurvePoint::G(
 	FieldInt("79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798"),
 	FieldInt("483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8"));
 const CurvePoint CurvePoint::ZERO;  // Default constructor
+const Uint256 CurvePoint::SQRT_EXPONENT("3FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFBFFFFF0C");
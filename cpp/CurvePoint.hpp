@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include "FieldInt.hpp"
 #include "Uint256.hpp"
@@ -32,6 +33,13 @@
  */
 class CurvePoint final {
 	
+	/*---- Helper structure ----*/
+	
+public:
+	struct MultiplesTable;  // Defined after this class
+	
+	
+	
 	/*---- Fields ----*/
 	
 public:
@@ -113,11 +121,35 @@ public:
 	
 	/*---- Static functions ----*/
 	
+	// Parses the given compressed point (header byte 0x02 or 0x03, x-coordinate in big-endian), recovering y with
+	// a field square root. If the x-coordinate is less than the field modulus and lies on the curve, then the output
+	// is set to the normalized point and true is returned. Otherwise the output is unchanged and false is returned.
+	// Not constant-time.
+	static bool fromCompressedPoint(const uint8_t input[33], CurvePoint &outPoint);
+	
+	
+	// Normalizes each of the given points, using only one field inversion for every 32 points.
+	// Gives the same results as calling normalize() on each point. Constant-time with respect to the values.
+	static void normalizeAll(CurvePoint points[], size_t len);
+	
+	
+	// Returns n * G, using tables of precomputed multiples of G that are built on the first call
+	// (with no point doublings needed afterward). The result is usually not normalized.
+	// Gives the same point as multiplying a copy of G. Constant-time with respect to the value.
+	static CurvePoint multiplyBasePoint(const Uint256 &n);
+	
+	
 	// Returns a normalized public curve point for the given private exponent key.
 	// Requires 0 < privExp < ORDER. Constant-time with respect to the value.
 	static CurvePoint privateExponentToPublicPoint(const Uint256 &privExp);
 	
 	
+private:
+	
+	// Returns the 64 normalized tables of multiples of (16^i * G), for 0 <= i < 64.
+	static const MultiplesTable *getBasePointTables();
+	
+	
 	/*---- Class constants ----*/
 	
 public:
@@ -129,4 +161,33 @@ public:
 	static const CurvePoint G;     // Base point (normalized)
 	static const CurvePoint ZERO;  // Dummy point at infinity (normalized)
 	
+private:
+	static const Uint256 SQRT_EXPONENT;  // (Field modulus + 1) / 4, because the modulus is 3 mod 4
+	
+};
+
+
+
+/* 
+ * The multiples [0*P, 1*P, ..., 15*P] of some curve point P, as used by the windowed
+ * point multiplication. Building the table once allows P to be multiplied repeatedly
+ * without recomputing it. Instances of this structure are mutable.
+ */
+struct CurvePoint::MultiplesTable final {
+	
+	CurvePoint points[16];
+	
+	
+	// Constructs the table of multiples of the given point. The entries are usually
+	// not normalized. Constant-time with respect to the value.
+	explicit MultiplesTable(const CurvePoint &p);
+	
+	
+	// Normalizes every entry of this table. Constant-time with respect to the values.
+	void normalize();
+	
+	
+	// Returns n * P. The result is usually not normalized. Constant-time with respect to both values.
+	CurvePoint multiply(const Uint256 &n) const;
+	
 };
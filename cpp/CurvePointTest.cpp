@@ -1108,6 +1108,85 @@ static void testIsOnCurve() {
 }
 
 
+static void testNormalizeAll() {
+	// Lengths that cover partial and multiple chunks
+	const size_t lengths[] = {0, 1, 2, 15, 32, 33, 70};
+	for (unsigned int i = 0; i < ARRAY_LENGTH(lengths); i++) {
+		size_t len = lengths[i];
+		std::vector<CurvePoint> points;
+		CurvePoint p(CurvePoint::G);
+		for (size_t j = 0; j < len; j++) {
+			if (j % 5 == 3)
+				points.push_back(CurvePoint::ZERO);
+			else
+				points.push_back(p);
+			p.twice();
+			p.add(CurvePoint::G);
+		}
+		std::vector<CurvePoint> expected(points);
+		for (CurvePoint &q : expected)
+			q.normalize();
+		CurvePoint::normalizeAll(points.data(), points.size());
+		for (size_t j = 0; j < len; j++)
+			assert(points[j] == expected[j]);
+		numTestCases++;
+	}
+}
+
+
+static void testMultiplesTable() {
+	const char *cases[] = {
+		"0000000000000000000000000000000000000000000000000000000000000000",
+		"0000000000000000000000000000000000000000000000000000000000000001",
+		"000000000000000000000000000000000000000000000000000000000000000F",
+		"89ABCDEF0123456789ABCDEF0123456789ABCDEF0123456789ABCDEF01234567",
+		"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364140",
+		"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364141",
+	};
+	CurvePoint base(CurvePoint::G);
+	base.multiply(Uint256("00000000000000000000000000000000000000000000000000000000DEADBEEF"));
+	base.normalize();
+	CurvePoint::MultiplesTable table(base);
+	table.normalize();
+	for (unsigned int i = 0; i < 16; i++)
+		assert(table.points[i].z == (i == 0 ? CurvePoint::FI_ZERO : CurvePoint::FI_ONE));
+	for (unsigned int i = 0; i < ARRAY_LENGTH(cases); i++) {
+		Uint256 n(cases[i]);
+		CurvePoint expected(base);
+		expected.multiply(n);
+		expected.normalize();
+		CurvePoint actual(table.multiply(n));
+		actual.normalize();
+		assert(actual == expected);
+		numTestCases++;
+	}
+}
+
+
+static void testMultiplyBasePoint() {
+	const char *cases[] = {
+		"0000000000000000000000000000000000000000000000000000000000000000",
+		"0000000000000000000000000000000000000000000000000000000000000001",
+		"0000000000000000000000000000000000000000000000000000000000000010",
+		"F000000000000000000000000000000000000000000000000000000000000000",
+		"3B0E8D2C6F4A1957C0D9E8F7A6B5C4D3E2F1A0B9C8D7E6F5A4B3C2D1E0F1A2B3",
+		"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364140",
+		"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364141",
+		"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF",
+	};
+	for (unsigned int i = 0; i < ARRAY_LENGTH(cases); i++) {
+		Uint256 n(cases[i]);
+		CurvePoint expected(CurvePoint::G);
+		expected.multiply(n);
+		expected.normalize();
+		CurvePoint actual(CurvePoint::multiplyBasePoint(n));
+		actual.normalize();
+		assert(actual == expected);
+		numTestCases++;
+	}
+}
+
+
 static void testPrivateExponentToPublicPoint() {
 	ThreeStrings cases[] = {
 		{"0000000000000000000000000000000000000000000000000000000000000001", "79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798", "483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8"},
@@ -1130,6 +1209,45 @@ static void testPrivateExponentToPublicPoint() {
 }
 
 
+static void testFromCompressedPoint() {
+	// Round trips through toCompressedPoint(), covering both parities of y
+	const char *privKeys[] = {
+		"0000000000000000000000000000000000000000000000000000000000000001",
+		"0000000000000000000000000000000000000000000000000000000000000002",
+		"000000000000000000000000000000000000000000000000000000000000000F",
+		"E8F32E723DECF4051AEFAC8E2C93C9C5B214313817CDB01A1494B917C8436B35",
+		"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD036413F",
+		"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364140",
+	};
+	for (unsigned int i = 0; i < ARRAY_LENGTH(privKeys); i++) {
+		CurvePoint expected(CurvePoint::privateExponentToPublicPoint(Uint256(privKeys[i])));
+		uint8_t bytes[33];
+		expected.toCompressedPoint(bytes);
+		CurvePoint actual(CurvePoint::ZERO);
+		assert(CurvePoint::fromCompressedPoint(bytes, actual));
+		assert(actual == expected);
+		numTestCases++;
+	}
+	
+	// Bad header byte, x not reduced, and x with no point on the curve
+	const char *invalid[] = {
+		"0479BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798",
+		"0079BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798",
+		"02FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFC2F",
+		"03FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF",
+		"020000000000000000000000000000000000000000000000000000000000000000",
+		"030000000000000000000000000000000000000000000000000000000000000005",
+	};
+	for (unsigned int i = 0; i < ARRAY_LENGTH(invalid); i++) {
+		Bytes bytes(hexBytes(invalid[i]));
+		CurvePoint actual(CurvePoint::G);
+		assert(!CurvePoint::fromCompressedPoint(bytes.data(), actual));
+		assert(actual == CurvePoint::G);
+		numTestCases++;
+	}
+}
+
+
 int main(int argc, char **argv) {
 	testReplace();
 	testTwice();
@@ -1137,7 +1255,11 @@ int main(int argc, char **argv) {
 	testMultiply();
 	testMultiplyModOrder();
 	testIsOnCurve();
+	testNormalizeAll();
+	testMultiplesTable();
+	testMultiplyBasePoint();
 	testPrivateExponentToPublicPoint();
+	testFromCompressedPoint();
 	printf("All %d test cases passed\n", numTestCases);
 	return 0;
 }
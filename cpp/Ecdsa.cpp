@@ -9,9 +9,11 @@
 #include <cassert>
 #include <cstdint>
 #include <cstring>
+#include <vector>
 #include "Ecdsa.hpp"
 #include "CurvePoint.hpp"
 #include "FieldInt.hpp"
+#include "Rfc6979.hpp"
 #include "Sha256.hpp"
 
 
@@ -32,8 +34,7 @@ bool Ecdsa::sign(const Uint256 &privateKey, const Sha256Hash &msgHash, const Uin
 	if (nonce == zero || nonce >= order)
 		return false;
 	
-	CurvePoint p(CurvePoint::G);
-	p.multiply(nonce);
+	CurvePoint p(CurvePoint::multiplyBasePoint(nonce));
 	p.normalize();
 	
 	Uint256 r(p.x);
@@ -75,6 +76,114 @@ bool Ecdsa::signWithHmacNonce(const Uint256 &privateKey, const Sha256Hash &msgHa
 }
 
 
+bool Ecdsa::signWithRfc6979Nonce(const Uint256 &privateKey, const Sha256Hash &msgHash, Uint256 &outR, Uint256 &outS) {
+	Rfc6979 generator(privateKey, msgHash);
+	for (int i = 0; i < 100; i++) {  // Each retry has a vanishing probability
+		if (sign(privateKey, msgHash, generator.nextNonce(), outR, outS))
+			return true;
+	}
+	return false;
+}
+
+
+bool Ecdsa::signBatch(const Uint256 &privateKey, const Sha256Hash msgHashes[], const Uint256 nonces[],
+		size_t len, Uint256 outR[], Uint256 outS[]) {
+	/* 
+	 * Same algorithm as sign(), except that in each chunk of messages, the points are normalized with
+	 * CurvePoint::normalizeAll(), and the nonces are inverted with Montgomery's trick:
+	 * prefix[i] = nonce[0] * ... * nonce[i - 1] % order;
+	 * inv = (prefix[len - 1] * nonce[len - 1])^-1 % order;
+	 * for (i = len - 1 .. 0) {
+	 *   nonceInv[i] = inv * prefix[i] % order;
+	 *   inv = inv * nonce[i] % order;
+	 * }
+	 * Invalid nonces are replaced by 1, so that every element takes the same steps.
+	 */
+	assert((msgHashes != nullptr && nonces != nullptr && outR != nullptr && outS != nullptr) || len == 0);
+	const Uint256 &order = CurvePoint::ORDER;
+	const Uint256 &zero = Uint256::ZERO;
+	const size_t CHUNK = 32;
+	std::vector<CurvePoint> points;
+	points.reserve(CHUNK);
+	bool result = true;
+	
+	for (size_t off = 0; off < len; off += CHUNK) {
+		size_t n = len - off < CHUNK ? len - off : CHUNK;
+		
+		// Nonce points, and the forward products
+		uint32_t valid[CHUNK];
+		Uint256 k[CHUNK];
+		Uint256 prefix[CHUNK];
+		Uint256 product(Uint256::ONE);
+		points.clear();
+		for (size_t i = 0; i < n; i++) {
+			k[i] = nonces[off + i];
+			valid[i] = static_cast<uint32_t>((k[i] != zero) & (k[i] < order));
+			k[i].replace(Uint256::ONE, valid[i] ^ 1);
+			points.push_back(CurvePoint::multiplyBasePoint(k[i]));
+			prefix[i] = product;
+			multiplyModOrder(product, k[i]);
+		}
+		CurvePoint::normalizeAll(points.data(), n);
+		product.reciprocal(order);
+		
+		for (size_t i = n; i-- > 0; ) {
+			Uint256 kInv(product);
+			multiplyModOrder(kInv, prefix[i]);
+			multiplyModOrder(product, k[i]);
+			
+			Uint256 r(points[i].x);
+			r.subtract(order, static_cast<uint32_t>(r >= order));
+			valid[i] &= static_cast<uint32_t>(r != zero);
+			
+			Uint256 s(r);
+			Uint256 z(msgHashes[off + i].value);
+			multiplyModOrder(s, privateKey);
+			uint32_t carry = s.add(z, 1);
+			s.subtract(order, carry | static_cast<uint32_t>(s >= order));
+			multiplyModOrder(s, kInv);
+			valid[i] &= static_cast<uint32_t>(s != zero);
+			
+			Uint256 negS(order);
+			negS.subtract(s);
+			s.replace(negS, static_cast<uint32_t>(negS < s));  // To ensure low S values for BIP 62
+			if (valid[i] == 1) {
+				outR[off + i] = r;
+				outS[off + i] = s;
+			} else
+				result = false;
+		}
+	}
+	return result;
+}
+
+
+bool Ecdsa::signBatchWithHmacNonce(const Uint256 &privateKey, const Sha256Hash msgHashes[],
+		size_t len, Uint256 outR[], Uint256 outS[]) {
+	uint8_t privkeyBytes[32] = {};
+	privateKey.getBigEndianBytes(privkeyBytes);
+	return signBatchWithHmacNonce(privateKey, HmacSha256Key(privkeyBytes, sizeof(privkeyBytes)), msgHashes, len, outR, outS);
+}
+
+
+bool Ecdsa::signBatchWithHmacNonce(const Uint256 &privateKey, const HmacSha256Key &hmacKey,
+		const Sha256Hash msgHashes[], size_t len, Uint256 outR[], Uint256 outS[]) {
+	assert((msgHashes != nullptr && outR != nullptr && outS != nullptr) || len == 0);
+	const size_t CHUNK = 32;
+	bool result = true;
+	for (size_t off = 0; off < len; off += CHUNK) {
+		size_t n = len - off < CHUNK ? len - off : CHUNK;
+		Uint256 nonces[CHUNK];
+		for (size_t i = 0; i < n; i++) {
+			const Sha256Hash hmac(Sha256::getHmac(hmacKey, msgHashes[off + i].value, SHA256_HASH_LEN));
+			nonces[i] = Uint256(hmac.value);
+		}
+		result &= signBatch(privateKey, &msgHashes[off], nonces, n, &outR[off], &outS[off]);
+	}
+	return result;
+}
+
+
 bool Ecdsa::verify(const CurvePoint &publicKey, const Sha256Hash &msgHash, const Uint256 &r, const Uint256 &s) {
 	/* 
 	 * Algorithm pseudocode:
@@ -92,13 +201,27 @@ bool Ecdsa::verify(const CurvePoint &publicKey, const Sha256Hash &msgHash, const
 	
 	const Uint256 &order = CurvePoint::ORDER;
 	const Uint256 &zero = Uint256::ZERO;
-	CurvePoint q(publicKey);
-	q.multiply(CurvePoint::ORDER);
 	if (!(zero < r && r < order && zero < s && s < order))
 		return false;
-	if (publicKey.isZero() || publicKey.z != CurvePoint::FI_ONE || !publicKey.isOnCurve() || !q.isZero())
+	if (!PreparedPublicKey::isValidPoint(publicKey))
 		return false;
-	
+	return verifyWithTable(CurvePoint::MultiplesTable(publicKey), msgHash, r, s);
+}
+
+
+bool Ecdsa::verify(const PreparedPublicKey &publicKey, const Sha256Hash &msgHash, const Uint256 &r, const Uint256 &s) {
+	const Uint256 &order = CurvePoint::ORDER;
+	const Uint256 &zero = Uint256::ZERO;
+	if (!(zero < r && r < order && zero < s && s < order))
+		return false;
+	if (!publicKey.isValid())
+		return false;
+	return verifyWithTable(publicKey.getTable(), msgHash, r, s);
+}
+
+
+bool Ecdsa::verifyWithTable(const CurvePoint::MultiplesTable &pubKeyTable, const Sha256Hash &msgHash, const Uint256 &r, const Uint256 &s) {
+	const Uint256 &order = CurvePoint::ORDER;
 	Uint256 w(s);
 	w.reciprocal(order);
 	Uint256 z(msgHash.value);
@@ -107,11 +230,8 @@ bool Ecdsa::verify(const CurvePoint &publicKey, const Sha256Hash &msgHash, const
 	multiplyModOrder(u1, z);
 	multiplyModOrder(u2, r);
 	
-	CurvePoint p(CurvePoint::G);
-	q = publicKey;
-	p.multiply(u1);
-	q.multiply(u2);
-	p.add(q);
+	CurvePoint p(CurvePoint::multiplyBasePoint(u1));
+	p.add(pubKeyTable.multiply(u2));
 	p.normalize();
 	
 	Uint256 px(p.x);
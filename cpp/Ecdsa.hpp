@@ -8,14 +8,18 @@
 
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include "CurvePoint.hpp"
+#include "PreparedPublicKey.hpp"
+#include "Sha256.hpp"
 #include "Sha256Hash.hpp"
 #include "Uint256.hpp"
 
 
 /* 
  * Performs ECDSA signature generation and verification.
- * Provides just three static methods.
+ * Provides just a few static methods.
  */
 class Ecdsa final {
 	
@@ -36,12 +40,49 @@ public:
 	static bool signWithHmacNonce(const Uint256 &privateKey, const Sha256Hash &msgHash, Uint256 &outR, Uint256 &outS);
 	
 	
+	// Computes the standard deterministic nonce specified in RFC 6979 (with HMAC-SHA-256), and then performs
+	// ECDSA signing, trying the next RFC 6979 nonce in the vanishing case that a nonce is unusable. The signatures
+	// match other RFC 6979 implementations, unlike signWithHmacNonce(). The private key must be in the range
+	// [1, CurvePoint::ORDER). Returns true iff signing is successful (always, with overwhelming probability).
+	static bool signWithRfc6979Nonce(const Uint256 &privateKey, const Sha256Hash &msgHash, Uint256 &outR, Uint256 &outS);
+	
+	
+	// Signs each of the len message hashes with the private key and the corresponding nonce, giving the same results
+	// as calling sign() on each one. outR[i] and outS[i] are assigned iff signing msgHashes[i] is successful, and the
+	// return value is true iff all of them are successful. The nonce points are normalized together and the nonces
+	// are inverted together, so this is faster than separate calls. Constant-time with respect to the secret values.
+	static bool signBatch(const Uint256 &privateKey, const Sha256Hash msgHashes[], const Uint256 nonces[],
+		size_t len, Uint256 outR[], Uint256 outS[]);
+	
+	
+	// Signs each of the len message hashes with the private key like signWithHmacNonce(), but
+	// with the batched computation of signBatch(). Returns true iff all of them are successful.
+	static bool signBatchWithHmacNonce(const Uint256 &privateKey, const Sha256Hash msgHashes[],
+		size_t len, Uint256 outR[], Uint256 outS[]);
+	
+	
+	// Same as the other signBatchWithHmacNonce(), but with the HMAC key context of the private key's 32 big-endian
+	// bytes already computed, such as the one that SigningContext keeps.
+	static bool signBatchWithHmacNonce(const Uint256 &privateKey, const HmacSha256Key &hmacKey,
+		const Sha256Hash msgHashes[], size_t len, Uint256 outR[], Uint256 outS[]);
+	
+	
 	// Checks whether the given signature, message, and public key are valid together. The public key point must be normalized.
 	static bool verify(const CurvePoint &publicKey, const Sha256Hash &msgHash, const Uint256 &r, const Uint256 &s);
 	
 	
+	// Checks whether the given signature, message, and prepared public key are valid together.
+	// Gives the same answer as the other verify(), but skips validating the key and building its table.
+	static bool verify(const PreparedPublicKey &publicKey, const Sha256Hash &msgHash, const Uint256 &r, const Uint256 &s);
+	
+	
 private:
 	
+	// Performs the part of verification that comes after the public key and the ranges of r and s are checked.
+	static bool verifyWithTable(const CurvePoint::MultiplesTable &pubKeyTable, const Sha256Hash &msgHash, const Uint256 &r, const Uint256 &s);
+	
+	
+	
 	// Computes x = (x * y) % CurvePoint::ORDER. Requires x < CurvePoint::ORDER, but y is unrestricted.
 	static void multiplyModOrder(Uint256 &x, const Uint256 &y);
 	
@@ -11,6 +11,8 @@
 #include "TestHelper.hpp"
 #include <cstdio>
 #include "Ecdsa.hpp"
+#include "PreparedPublicKey.hpp"
+#include "Sha256.hpp"
 #include "Sha256Hash.hpp"
 #include "Uint256.hpp"
 
@@ -727,6 +729,8 @@ static void testEcdsaSignAndVerify() {
 		if (Uint256::ZERO < privateKey && privateKey < CurvePoint::ORDER) {
 			CurvePoint publicKey(CurvePoint::privateExponentToPublicPoint(privateKey));
 			assert(Ecdsa::verify(publicKey, msgHash, r, s));
+			const PreparedPublicKey prepared(publicKey);
+			assert(prepared.isValid() && Ecdsa::verify(prepared, msgHash, r, s));
 		}
 		
 		numTestCases++;
@@ -734,6 +738,53 @@ static void testEcdsaSignAndVerify() {
 }
 
 
+static void testEcdsaSignBatch() {
+	const char *nonces[] = {
+		"0000000000000000000000000000000000000000000000000000000000000001",
+		"2C9B3F0E5A7D8C1B4E6F0A2D3C5B7E9F1A3C5E7092B4D6F8A1C3E5072946B8DA",
+		"0000000000000000000000000000000000000000000000000000000000000000",  // Invalid
+		"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364140",
+		"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364141",  // Invalid
+		"7E5E2242246CA4A2A7F8777B5B8C5496D468636BC298CFF4442A047B06FFED38",
+	};
+	const char *privateKeys[] = {
+		"0000000000000000000000000000000000000000000000000000000000000001",
+		"C1014E82EEE3CD4AECBB43029CD0C4A38F57108887BFD39D4196EFB92A1A81C5",
+	};
+	const size_t len = 70;  // Spans several chunks
+	std::vector<Sha256Hash> hashes;
+	std::vector<Uint256> nonceVals;
+	for (size_t i = 0; i < len; i++) {
+		uint8_t msg[1] = {static_cast<uint8_t>(i)};
+		hashes.push_back(Sha256::getHash(msg, sizeof(msg)));
+		nonceVals.push_back(Uint256(nonces[i % ARRAY_LENGTH(nonces)]));
+		nonceVals.back().value[1] ^= static_cast<uint32_t>(i / ARRAY_LENGTH(nonces));
+	}
+	
+	for (unsigned int i = 0; i < ARRAY_LENGTH(privateKeys); i++) {
+		Uint256 privateKey(privateKeys[i]);
+		std::vector<Uint256> rs(len, Uint256::ZERO), ss(len, Uint256::ZERO);
+		assert(!Ecdsa::signBatch(privateKey, hashes.data(), nonceVals.data(), len, rs.data(), ss.data()));
+		for (size_t j = 0; j < len; j++) {
+			Uint256 r(Uint256::ZERO), s(Uint256::ZERO);
+			bool ok = Ecdsa::sign(privateKey, hashes[j], nonceVals[j], r, s);
+			assert(rs[j] == r && ss[j] == s);
+			assert(ok == (r != Uint256::ZERO));
+			numTestCases++;
+		}
+		
+		std::vector<Uint256> hmacRs(len), hmacSs(len);
+		assert(Ecdsa::signBatchWithHmacNonce(privateKey, hashes.data(), len, hmacRs.data(), hmacSs.data()));
+		for (size_t j = 0; j < len; j += 7) {
+			Uint256 r, s;
+			assert(Ecdsa::signWithHmacNonce(privateKey, hashes[j], r, s));
+			assert(hmacRs[j] == r && hmacSs[j] == s);
+			numTestCases++;
+		}
+	}
+}
+
+
 static void testEcdsaVerify() {
 	VerifyCase cases[] = {
 		{false, "77D9ECB1D22A45C107EE36FC6D62A4D32BAB6689A50F0FAE587E0B95A795E833", "9BB5CF3051C7FCD5B69CB80A59B052D75BB6C6090B28C1E5AC0C6502B04BE63B", "EF54D03E7453CED1A0A9529ADFBE46CE7440E40E3457CA1C040B6CAC9E3209E4", "EB4E0C2C1723EFE8192F2F8743D343F45B5B8A9A12012EE71743247B0F65DAD8", "08F4E06799E5919F72EE39D3473EB473BD8ADC672694D895734E8AE4D049E038"},
@@ -1809,6 +1860,8 @@ static void testEcdsaVerify() {
 		Uint256 r(tc.rValue);
 		Uint256 s(tc.sValue);
 		assert(Ecdsa::verify(publicKey, msgHash, r, s) == tc.answer);
+		const PreparedPublicKey prepared(publicKey);
+		assert(Ecdsa::verify(prepared, msgHash, r, s) == tc.answer);
 		numTestCases++;
 	}
 }
@@ -1816,6 +1869,7 @@ static void testEcdsaVerify() {
 
 int main(int argc, char **argv) {
 	testEcdsaSignAndVerify();
+	testEcdsaSignBatch();
 	testEcdsaVerify();
 	printf("All %d test cases passed\n", numTestCases);
 	return 0;
@@ -0,0 +1,281 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include <cassert>
+#include <cstring>
+#include <vector>
+#include "Base58Check.hpp"
+#include "ExtendedKey.hpp"
+#include "Sha512.hpp"
+
+
+/*---- Constructors ----*/
+
+ExtendedKey::ExtendedKey() :
+		privateKey(Uint256::ZERO),
+		publicKey(CurvePoint::ZERO),
+		publicKeyBytes(),
+		identifier(),
+		chainCode(),
+		parentFingerprint(),
+		childNumber(0),
+		depth(0),
+		hasPrivate(false) {}
+
+
+
+/*---- Methods ----*/
+
+bool ExtendedKey::isPrivate() const {
+	return hasPrivate;
+}
+
+
+const Uint256 &ExtendedKey::getPrivateKey() const {
+	assert(hasPrivate);
+	return privateKey;
+}
+
+
+const CurvePoint &ExtendedKey::getPublicKey() const {
+	return publicKey;
+}
+
+
+void ExtendedKey::getPublicKeyBytes(uint8_t output[33]) const {
+	assert(output != nullptr);
+	memcpy(output, publicKeyBytes, sizeof(publicKeyBytes));
+}
+
+
+void ExtendedKey::getIdentifier(uint8_t output[HASH160_LEN]) const {
+	assert(output != nullptr);
+	memcpy(output, identifier, sizeof(identifier));
+}
+
+
+void ExtendedKey::getChainCode(uint8_t output[32]) const {
+	assert(output != nullptr);
+	memcpy(output, chainCode, sizeof(chainCode));
+}
+
+
+void ExtendedKey::getParentFingerprint(uint8_t output[4]) const {
+	assert(output != nullptr);
+	memcpy(output, parentFingerprint, sizeof(parentFingerprint));
+}
+
+
+uint32_t ExtendedKey::getChildNumber() const {
+	return childNumber;
+}
+
+
+int ExtendedKey::getDepth() const {
+	return depth;
+}
+
+
+ExtendedKey ExtendedKey::toPublic() const {
+	ExtendedKey result(*this);
+	result.privateKey = Uint256::ZERO;
+	result.hasPrivate = false;
+	return result;
+}
+
+
+bool ExtendedKey::deriveChild(uint32_t index, ExtendedKey &outChild) const {
+	ExtendedKey child;  // So that outChild may alias this key
+	if (!deriveRange(*this, index, 1, &child))
+		return false;
+	outChild = child;
+	return true;
+}
+
+
+void ExtendedKey::toBase58Check(char outStr[112]) const {
+	assert(outStr != nullptr);
+	uint8_t payload[74];
+	payload[0] = depth;
+	memcpy(&payload[1], parentFingerprint, 4);
+	for (int i = 0; i < 4; i++)
+		payload[5 + i] = static_cast<uint8_t>(childNumber >> ((3 - i) << 3));
+	memcpy(&payload[9], chainCode, 32);
+	if (hasPrivate) {
+		payload[41] = 0x00;
+		privateKey.getBigEndianBytes(&payload[42]);
+	} else
+		memcpy(&payload[41], publicKeyBytes, 33);
+	size_t len = Base58Check::encode(hasPrivate ? PRIVATE_VERSION : PUBLIC_VERSION, 4, payload, sizeof(payload), outStr);
+	assert(len == 111);
+	(void)len;
+}
+
+
+void ExtendedKey::cachePublicKey() {
+	publicKey.toCompressedPoint(publicKeyBytes);
+	Hash160::getHash33(publicKeyBytes, identifier);
+}
+
+
+
+/*---- Static functions ----*/
+
+bool ExtendedKey::fromSeed(const uint8_t *seed, size_t seedLen, ExtendedKey &outKey) {
+	assert(seed != nullptr || seedLen == 0);
+	const char *hmacKey = "Bitcoin seed";
+	uint8_t hmac[SHA512_HASH_LEN];
+	Sha512::getHmac(reinterpret_cast<const uint8_t *>(hmacKey), strlen(hmacKey), seed, seedLen, hmac);
+	Uint256 key(hmac);
+	if (key == Uint256::ZERO || key >= CurvePoint::ORDER)
+		return false;
+	
+	ExtendedKey result;
+	result.privateKey = key;
+	result.publicKey = CurvePoint::privateExponentToPublicPoint(key);
+	result.cachePublicKey();
+	memcpy(result.chainCode, &hmac[32], 32);
+	result.hasPrivate = true;
+	outKey = result;
+	return true;
+}
+
+
+bool ExtendedKey::fromBase58Check(const char *str, ExtendedKey &outKey) {
+	assert(str != nullptr);
+	uint8_t version[4];
+	uint8_t payload[74];
+	if (!Base58Check::decode(str, version, sizeof(version), payload, sizeof(payload)))
+		return false;
+	
+	// Check the version and position fields
+	ExtendedKey result;
+	if (memcmp(version, PRIVATE_VERSION, 4) == 0)
+		result.hasPrivate = true;
+	else if (memcmp(version, PUBLIC_VERSION, 4) != 0)
+		return false;
+	result.depth = payload[0];
+	memcpy(result.parentFingerprint, &payload[1], 4);
+	for (int i = 0; i < 4; i++)
+		result.childNumber = (result.childNumber << 8) | payload[5 + i];
+	static const uint8_t zeros[4] = {};
+	if (result.depth == 0 && (memcmp(result.parentFingerprint, zeros, 4) != 0 || result.childNumber != 0))
+		return false;
+	memcpy(result.chainCode, &payload[9], 32);
+	
+	// Check the key data
+	if (result.hasPrivate) {
+		Uint256 key(&payload[42]);
+		if (payload[41] != 0x00 || key == Uint256::ZERO || key >= CurvePoint::ORDER)
+			return false;
+		result.privateKey = key;
+		result.publicKey = CurvePoint::privateExponentToPublicPoint(key);
+	} else if (!CurvePoint::fromCompressedPoint(&payload[41], result.publicKey))
+		return false;
+	result.cachePublicKey();
+	outKey = result;
+	return true;
+}
+
+
+bool ExtendedKey::deriveRange(const ExtendedKey &parentArg, uint32_t start, size_t count, ExtendedKey outChildren[]) {
+	/*
+	 * For each index i, the HMAC of the parent's chain code and data gives the 32-byte tweak IL and the child's
+	 * chain code IR. A private child key is (IL + k) mod n, and its point comes from the precomputed tables of G.
+	 * A public child point is IL * G + K, which uses the same tables plus one point addition.
+	 */
+	assert(outChildren != nullptr || count == 0);
+	if (count == 0)
+		return true;
+	assert(count - 1 <= UINT32_C(0xFFFFFFFF) - start);
+	if (parentArg.depth == 0xFF || (!parentArg.hasPrivate && start >= HARDENED))
+		return false;  // No child can be derived
+	
+	const ExtendedKey parent(parentArg);  // A copy, because outChildren may contain the parent
+	const HmacSha512Key hmacKey(parent.chainCode, sizeof(parent.chainCode));
+	const Uint256 &order = CurvePoint::ORDER;
+	const size_t CHUNK = 32;
+	bool result = true;
+	for (size_t off = 0; off < count; off += CHUNK) {
+		size_t n = count - off < CHUNK ? count - off : CHUNK;
+		
+		// HMAC data: the serialized parent key (private for hardened children), then the big-endian index.
+		// A public parent has no hardened children, but hashing its public key for them keeps the batch uniform.
+		uint8_t data[CHUNK][37];
+		uint8_t hmacs[CHUNK][SHA512_HASH_LEN];
+		const uint8_t *dataPtrs[CHUNK];
+		uint8_t *hmacPtrs[CHUNK];
+		bool valid[CHUNK];
+		for (size_t i = 0; i < n; i++) {
+			uint32_t index = start + static_cast<uint32_t>(off + i);
+			valid[i] = parent.hasPrivate || index < HARDENED;
+			if (index >= HARDENED && parent.hasPrivate) {
+				data[i][0] = 0x00;
+				parent.privateKey.getBigEndianBytes(&data[i][1]);
+			} else
+				memcpy(data[i], parent.publicKeyBytes, 33);
+			for (int j = 0; j < 4; j++)
+				data[i][33 + j] = static_cast<uint8_t>(index >> ((3 - j) << 3));
+			dataPtrs[i] = data[i];
+			hmacPtrs[i] = hmacs[i];
+		}
+		Sha512::getHmacMulti(hmacKey, dataPtrs, 37, n, hmacPtrs);
+		
+		// Tweak the parent key, and compute the unnormalized child points
+		Uint256 childKeys[CHUNK];
+		std::vector<CurvePoint> points;
+		points.reserve(n);
+		for (size_t i = 0; i < n; i++) {
+			Uint256 tweak(hmacs[i]);
+			valid[i] &= tweak < order;
+			if (parent.hasPrivate) {
+				Uint256 &k = childKeys[i];
+				k = tweak;
+				uint32_t carry = k.add(parent.privateKey);
+				k.subtract(order, carry | static_cast<uint32_t>(k >= order));
+				valid[i] &= k != Uint256::ZERO;
+				points.push_back(CurvePoint::multiplyBasePoint(k));
+			} else {
+				childKeys[i] = Uint256::ZERO;
+				points.push_back(CurvePoint::multiplyBasePoint(tweak));
+				points.back().add(parent.publicKey);
+			}
+		}
+		CurvePoint::normalizeAll(points.data(), n);
+		
+		// Serialize and hash the child public keys together
+		uint8_t pubKeys[CHUNK * 33];
+		uint8_t identifiers[CHUNK * HASH160_LEN];
+		for (size_t i = 0; i < n; i++)
+			points[i].toCompressedPoint(&pubKeys[i * 33]);
+		Hash160::getHashMulti(pubKeys, 33, n, identifiers);
+		
+		for (size_t i = 0; i < n; i++) {
+			if (!valid[i] || points[i].isZero()) {
+				result = false;
+				continue;
+			}
+			ExtendedKey &child = outChildren[off + i];
+			child.privateKey = childKeys[i];
+			child.publicKey = points[i];
+			memcpy(child.publicKeyBytes, &pubKeys[i * 33], 33);
+			memcpy(child.identifier, &identifiers[i * HASH160_LEN], HASH160_LEN);
+			memcpy(child.chainCode, &hmacs[i][32], 32);
+			memcpy(child.parentFingerprint, parent.identifier, 4);
+			child.childNumber = start + static_cast<uint32_t>(off + i);
+			child.depth = static_cast<uint8_t>(parent.depth + 1);
+			child.hasPrivate = parent.hasPrivate;
+		}
+	}
+	return result;
+}
+
+
+// Static initializers
+const uint8_t ExtendedKey::PRIVATE_VERSION[4] = {0x04, 0x88, 0xAD, 0xE4};
+const uint8_t ExtendedKey::PUBLIC_VERSION[4] = {0x04, 0x88, 0xB2, 0x1E};
@@ -0,0 +1,142 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "CurvePoint.hpp"
+#include "Hash160.hpp"
+#include "Uint256.hpp"
+
+
+/* 
+ * A BIP32 hierarchical deterministic key (xprv or xpub): a private or public key together with
+ * its chain code and its position in the key tree. Children are derived with HMAC-SHA-512 keyed by
+ * the chain code. Every key caches the HASH160 of its public key, whose first 4 bytes become the parent
+ * fingerprint of its children. Instances of this class are immutable except by assignment.
+ */
+class ExtendedKey final {
+	
+	/*---- Fields ----*/
+	
+private:
+	Uint256 privateKey;  // Zero for public keys
+	CurvePoint publicKey;  // Normalized
+	uint8_t publicKeyBytes[33];  // Compressed form of publicKey
+	uint8_t identifier[HASH160_LEN];  // HASH160 of publicKeyBytes
+	uint8_t chainCode[32];
+	uint8_t parentFingerprint[4];
+	uint32_t childNumber;
+	uint8_t depth;
+	bool hasPrivate;
+	
+	
+	
+	/*---- Constructors ----*/
+public:
+	
+	// Constructs a blank public key whose point is CurvePoint::ZERO. For clarity, only use this constructor
+	// if the variable will be overwritten, such as for the output array of deriveRange().
+	ExtendedKey();
+	
+	
+	
+	/*---- Methods ----*/
+	
+	// Tests whether this is an extended private key (xprv), as opposed to an extended public key (xpub).
+	bool isPrivate() const;
+	
+	
+	// Returns the private key. Requires isPrivate() to be true.
+	const Uint256 &getPrivateKey() const;
+	
+	
+	// Returns the public key point, which is normalized.
+	const CurvePoint &getPublicKey() const;
+	
+	
+	// Writes the public key in compressed form.
+	void getPublicKeyBytes(uint8_t output[33]) const;
+	
+	
+	// Writes the HASH160 of the compressed public key, which is the pubkey hash in P2PKH and P2WPKH addresses.
+	// The first 4 bytes are this key's fingerprint.
+	void getIdentifier(uint8_t output[HASH160_LEN]) const;
+	
+	
+	void getChainCode(uint8_t output[32]) const;
+	
+	
+	void getParentFingerprint(uint8_t output[4]) const;
+	
+	
+	uint32_t getChildNumber() const;
+	
+	
+	int getDepth() const;
+	
+	
+	// Returns the extended public key with the same public key, chain code and position as this key.
+	ExtendedKey toPublic() const;
+	
+	
+	// Derives the child key at the given index, which is hardened if it is at least HARDENED. Returns true
+	// if successful. Returns false and leaves the output unchanged if a public key is asked for a hardened child,
+	// if this key is at the maximum depth, or if the index gives an invalid key (vanishing probability, in which
+	// case BIP32 says to proceed with the next index). Constant-time with respect to the private key.
+	bool deriveChild(uint32_t index, ExtendedKey &outChild) const;
+	
+	
+	// Serializes this key as 111 Base58Check characters with the mainnet xprv or xpub version prefix.
+	// The outStr array must have length >= 112 (including null terminator).
+	void toBase58Check(char outStr[112]) const;
+	
+	
+	
+	/*---- Static functions ----*/
+	
+	// Computes the master key for the given seed (typically 16 to 64 bytes). Returns true if successful.
+	// Returns false and leaves the output unchanged if the seed gives an invalid key (vanishing probability).
+	static bool fromSeed(const uint8_t *seed, size_t seedLen, ExtendedKey &outKey);
+	
+	
+	// Parses the given mainnet xprv or xpub string. If the syntax, check digits, version, key data and
+	// depth-zero fields are all valid, then the output is set and true is returned. Otherwise the output
+	// is unchanged and false is returned. Not constant-time.
+	static bool fromBase58Check(const char *str, ExtendedKey &outKey);
+	
+	
+	// Derives the count children with indexes start, start + 1, ..., start + count - 1 of the given parent, giving
+	// the same results as calling deriveChild() on each one. outChildren[i] is assigned iff deriving that child is
+	// successful (so for a public parent, only the non-hardened children are assigned), and the return value is true
+	// iff all of them are successful. The chain code is keyed into HMAC once, the HMACs go through multi-buffer
+	// SHA-512, the points are normalized together, and their HASH160s go through multi-buffer hashing. In repeated
+	// measurements this was 15% to 25% faster per private child than separate calls, but under 10% faster per
+	// public child. The indexes must not wrap around past 2^32 - 1, but outChildren may contain the parent.
+	// Constant-time with respect to the private key.
+	static bool deriveRange(const ExtendedKey &parent, uint32_t start, size_t count, ExtendedKey outChildren[]);
+	
+	
+private:
+	
+	// Sets publicKeyBytes and identifier from publicKey.
+	void cachePublicKey();
+	
+	
+	
+	/*---- Class constants ----*/
+	
+public:
+	static const uint32_t HARDENED = UINT32_C(0x80000000);  // Child indexes at least this value are hardened
+	
+private:
+	static const uint8_t PRIVATE_VERSION[4];  // Mainnet xprv
+	static const uint8_t PUBLIC_VERSION[4];   // Mainnet xpub
+	
+};
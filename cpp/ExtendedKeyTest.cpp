@@ -0,0 +1,186 @@
+/* 
+ * A runnable main program that tests the functionality of class ExtendedKey.
+ * 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include "TestHelper.hpp"
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include "ExtendedKey.hpp"
+
+
+/*---- Structures ----*/
+
+struct ChainCase {
+	uint32_t index;
+	const char *xpub;
+	const char *xprv;
+};
+
+
+// Global variables
+static int numTestCases = 0;
+
+
+/*---- Test suite ----*/
+
+static bool equals(const ExtendedKey &key, const char *str) {
+	char actual[112];
+	key.toBase58Check(actual);
+	return strcmp(actual, str) == 0;
+}
+
+
+static void testVector1() {
+	// BIP32 test vector 1, chain m/0H/1/2H/2/1000000000
+	ChainCase cases[] = {
+		{0, "xpub661MyMwAqRbcFtXgS5sYJABqqG9YLmC4Q1Rdap9gSE8NqtwybGhePY2gZ29ESFjqJoCu1Rupje8YtGqsefD265TMg7usUDFdp6W1EGMcet8",
+			"xprv9s21ZrQH143K3QTDL4LXw2F7HEK3wJUD2nW2nRk4stbPy6cq3jPPqjiChkVvvNKmPGJxWUtg6LnF5kejMRNNU3TGtRBeJgk33yuGBxrMPHi"},
+		{ExtendedKey::HARDENED + 0, "xpub68Gmy5EdvgibQVfPdqkBBCHxA5htiqg55crXYuXoQRKfDBFA1WEjWgP6LHhwBZeNK1VTsfTFUHCdrfp1bgwQ9xv5ski8PX9rL2dZXvgGDnw",
+			"xprv9uHRZZhk6KAJC1avXpDAp4MDc3sQKNxDiPvvkX8Br5ngLNv1TxvUxt4cV1rGL5hj6KCesnDYUhd7oWgT11eZG7XnxHrnYeSvkzY7d2bhkJ7"},
+		{1, "xpub6ASuArnXKPbfEwhqN6e3mwBcDTgzisQN1wXN9BJcM47sSikHjJf3UFHKkNAWbWMiGj7Wf5uMash7SyYq527Hqck2AxYysAA7xmALppuCkwQ",
+			"xprv9wTYmMFdV23N2TdNG573QoEsfRrWKQgWeibmLntzniatZvR9BmLnvSxqu53Kw1UmYPxLgboyZQaXwTCg8MSY3H2EU4pWcQDnRnrVA1xe8fs"},
+		{ExtendedKey::HARDENED + 2, "xpub6D4BDPcP2GT577Vvch3R8wDkScZWzQzMMUm3PWbmWvVJrZwQY4VUNgqFJPMM3No2dFDFGTsxxpG5uJh7n7epu4trkrX7x7DogT5Uv6fcLW5",
+			"xprv9z4pot5VBttmtdRTWfWQmoH1taj2axGVzFqSb8C9xaxKymcFzXBDptWmT7FwuEzG3ryjH4ktypQSAewRiNMjANTtpgP4mLTj34bhnZX7UiM"},
+		{2, "xpub6FHa3pjLCk84BayeJxFW2SP4XRrFd1JYnxeLeU8EqN3vDfZmbqBqaGJAyiLjTAwm6ZLRQUMv1ZACTj37sR62cfN7fe5JnJ7dh8zL4fiyLHV",
+			"xprvA2JDeKCSNNZky6uBCviVfJSKyQ1mDYahRjijr5idH2WwLsEd4Hsb2Tyh8RfQMuPh7f7RtyzTtdrbdqqsunu5Mm3wDvUAKRHSC34sJ7in334"},
+		{1000000000, "xpub6H1LXWLaKsWFhvm6RVpEL9P4KfRZSW7abD2ttkWP3SSQvnyA8FSVqNTEcYFgJS2UaFcxupHiYkro49S8yGasTvXEYBVPamhGW6cFJodrTHy",
+			"xprvA41z7zogVVwxVSgdKUHDy1SKmdb533PjDz7J6N6mV6uS3ze1ai8FHa8kmHScGpWmj4WggLyQjgPie1rFSruoUihUZREPSL39UNdE3BBDu76"},
+	};
+	
+	Bytes seed(hexBytes("000102030405060708090A0B0C0D0E0F"));
+	ExtendedKey key;
+	assert(ExtendedKey::fromSeed(seed.data(), seed.size(), key));
+	uint8_t fingerprint[HASH160_LEN];
+	key.getIdentifier(fingerprint);
+	assert(memcmp(fingerprint, hexBytes("3442193E1BB70916E914552172CD4E2DBC9DF811").data(), HASH160_LEN) == 0);
+	
+	for (unsigned int i = 0; i < ARRAY_LENGTH(cases); i++) {
+		ChainCase &tc = cases[i];
+		if (i > 0) {
+			ExtendedKey parent(key);
+			assert(key.deriveChild(tc.index, key));  // Output aliases the parent
+			
+			// Public derivation from the parent's xpub must agree, except for hardened children
+			ExtendedKey pubChild;
+			bool ok = parent.toPublic().deriveChild(tc.index, pubChild);
+			assert(ok == (tc.index < ExtendedKey::HARDENED));
+			if (ok)
+				assert(equals(pubChild, tc.xpub));
+			
+			uint8_t parentFingerprint[4];
+			parent.getIdentifier(fingerprint);
+			key.getParentFingerprint(parentFingerprint);
+			assert(memcmp(parentFingerprint, fingerprint, 4) == 0);
+		}
+		assert(key.isPrivate() && key.getDepth() == static_cast<int>(i) && key.getChildNumber() == tc.index);
+		assert(equals(key, tc.xprv) && equals(key.toPublic(), tc.xpub));
+		
+		// Round trips through parsing
+		ExtendedKey parsed;
+		assert(ExtendedKey::fromBase58Check(tc.xprv, parsed) && parsed.isPrivate() && equals(parsed, tc.xprv));
+		assert(parsed.getPrivateKey() == key.getPrivateKey() && parsed.getPublicKey() == key.getPublicKey());
+		assert(ExtendedKey::fromBase58Check(tc.xpub, parsed) && !parsed.isPrivate() && equals(parsed, tc.xpub));
+		assert(parsed.getPublicKey() == key.getPublicKey());
+		numTestCases++;
+	}
+}
+
+
+static void testInvalidStrings() {
+	const char *cases[] = {
+		"xpubEPi3iGSX9RiyvsV1Di18LRuDrFpz6df7c66p4wnNJAPnoasbg8Cz2EL4st4MxPJkjGD2cuow7PNo7bnjvJiKATe4D5SsVPBpUxLzYWtrgz1",  // Unknown version
+		"xpub661ntjtSEDiPCjvciP6pCLLxeAybDc7Taf5uSN6GbH4UutJXnNNfgK43TdraRHfbfXCqrBY3w2hVKuWiMe73bminxG2maTP29aWaDpxYPw7",  // Depth 0 with parent fingerprint
+		"xpub661MyMwAqRbcJSMey3ddJhFon1i55f2nLYgX5LxBDabkRyAsvzgomLjsqFzpRTFkwhazZ36LecmLvsoS7aLKHNc4nYPgvP3geewEjpUTwEd",  // Depth 0 with child number
+		"xpub661MyMwAqRbcFtXgS5sYJABqqG9YLmC4Q1Rdap9gSE8NqtwybGhePY2gZ45ycVBsADt89FVXeDkYqbSeZmpjjnJETkyyiMwXokWPisrtUjm",  // Public key prefix 0x04
+		"xpub661MyMwAqRbcFtXgS5sYJABqqG9YLmC4Q1Rdap9gSE8NqtwybGhePY2gYym6yCVZtiQKSpLUqpuy2xafsZZR8vydJmD1kZ1yXu2LotCeeYJ",  // x not on the curve
+		"xprv9s21ZrQH143K3QTDL4LXw2F7HEK3wJUD2nW2nRk4stbPy6cq3jPPqjiChijLXZSun8bsGj49MuvWWsqL9fqS5fhiDUkRQvq8cj8L42RGwHP",  // Private key 0
+		"xprv9s21ZrQH143K3QTDL4LXw2F7HEK3wJUD2nW2nRk4stbPy6cq3jPPqjiChkg5hntwdZH6QYdrGVYWUCS2Xv6FCMHoYQZYQDohv67LnGTwiNd",  // Private key n
+		"xprv9s21ZrQH143K3QTDL4LXw2F7HEK3wJUD2nW2nRk4stbPy6cq3jPPqjiChnSg6bmoEgzBeJUNzvQF35FWGXz67kJ9g4FkYqRw3duegVvnguE",  // Private key prefix 0x01
+		"xprv9s21ZrQH143K3QTDL4LXw2F7HEK3wJUD2nW2nRk4stbPy6cq3jPPqjiChpzxM5bEu4ku6ynu4tP6GqJ5kziULDsCA7bVctSatEcmUDntDMZ",  // Public key in xprv
+		"xpub661MyMwAqRbcFtXgS5sYJABqqG9YLmC4Q1Rdap9gSE8NqtwybGhePY2gYweD1YUMnzkxQw1bm6XhhCCXF5rvDu3SQRW2A1Z5yqnVwyY4cNT",  // Private key in xpub
+		"Deb7pNXSbX7qSvc2eMjkNYTrggh4pBgYa2QMFjEjj6hUy1i6QK7Zm1qdZkHEwqHpT7WeE6V55dTU8PuuzPAiP8JDwAcsuN3v858r83c7mPeYLX",  // Too short
+		"xpub661MyMwAqRbcFtXgS5sYJABqqG9YLmC4Q1Rdap9gSE8NqtwybGhePY2gZ29ESFjqJoCu1Rupje8YtGqsefD265TMg7usUDFdp6W1EGMcet9",  // Bad check digit
+		"",
+	};
+	for (unsigned int i = 0; i < ARRAY_LENGTH(cases); i++) {
+		ExtendedKey key;
+		assert(!ExtendedKey::fromBase58Check(cases[i], key));
+		assert(key.getPublicKey() == CurvePoint::ZERO);
+		numTestCases++;
+	}
+}
+
+
+static void testDeriveRange() {
+	Bytes seed(hexBytes("FFFCF9F6F3F0EDEAE7E4E1DEDBD8D5D2CFCCC9C6C3C0BDBAB7B4B1AEABA8A5A29F9C999693908D8A8784817E7B7875726F6C696663605D5A5754514E4B484542"));
+	ExtendedKey master;
+	assert(ExtendedKey::fromSeed(seed.data(), seed.size(), master));
+	const ExtendedKey parents[] = {master, master.toPublic()};
+	
+	struct Range {
+		uint32_t start;
+		size_t count;
+	};
+	const Range ranges[] = {
+		{0, 0}, {0, 1}, {5, 31}, {0, 32}, {100, 33}, {7, 70},
+		{ExtendedKey::HARDENED - 3, 6},  // Crosses into hardened indexes
+		{ExtendedKey::HARDENED - 40, 45},  // Crosses in a later chunk
+		{ExtendedKey::HARDENED, 3},  // Only hardened indexes
+		{UINT32_C(0xFFFFFFFF) - 4, 5},  // Ends at the last index
+	};
+	for (unsigned int i = 0; i < ARRAY_LENGTH(parents); i++) {
+		const ExtendedKey &parent = parents[i];
+		for (unsigned int j = 0; j < ARRAY_LENGTH(ranges); j++) {
+			const Range &r = ranges[j];
+			std::vector<ExtendedKey> children(r.count);
+			bool ok = ExtendedKey::deriveRange(parent, r.start, r.count, children.data());
+			bool hasHardened = r.count > 0 && r.start + static_cast<uint32_t>(r.count - 1) >= ExtendedKey::HARDENED;
+			assert(ok == (parent.isPrivate() || !hasHardened));
+			for (size_t k = 0; k < r.count; k++) {
+				ExtendedKey expect;
+				if (!parent.deriveChild(r.start + static_cast<uint32_t>(k), expect)) {
+					// A hardened child of a public parent is left unassigned
+					assert(!parent.isPrivate() && children[k].getPublicKey() == CurvePoint::ZERO);
+					continue;
+				}
+				char expectStr[112];
+				expect.toBase58Check(expectStr);
+				assert(equals(children[k], expectStr));
+				uint8_t a[HASH160_LEN], b[HASH160_LEN];
+				children[k].getIdentifier(a);
+				expect.getIdentifier(b);
+				assert(memcmp(a, b, HASH160_LEN) == 0);
+			}
+			numTestCases++;
+		}
+		
+		// The output array may contain the parent itself, which gets overwritten by the first child
+		ExtendedKey inPlace[3] = {parent, parent, parent};
+		assert(ExtendedKey::deriveRange(inPlace[1], 4, 3, inPlace));
+		for (uint32_t k = 0; k < 3; k++) {
+			ExtendedKey expect;
+			assert(parent.deriveChild(4 + k, expect));
+			char expectStr[112];
+			expect.toBase58Check(expectStr);
+			assert(equals(inPlace[k], expectStr));
+		}
+		numTestCases++;
+	}
+}
+
+
+int main(int argc, char **argv) {
+	testVector1();
+	testInvalidStrings();
+	testDeriveRange();
+	printf("All %d test cases passed\n", numTestCases);
+	return 0;
+}
@@ -0,0 +1,111 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include <cassert>
+#include <chrono>
+#include <vector>
+#include "FileHasher.hpp"
+#include "Sha256.hpp"
+
+
+// Appends the rest of the given stream to the given hasher (Sha256, Sha512 or Ripemd160) in chunks of CHUNK_LEN
+// bytes. Returns true and sets the stats (if not null) on success, or returns false if a read error occurred.
+template <typename Hasher>
+static bool appendStream(std::FILE *file, Hasher &hasher, FileHasher::Stats *stats) {
+	assert(file != nullptr);
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	
+	// Allocated once per call; whole blocks are compressed in place from this buffer
+	std::vector<uint8_t> buffer(FileHasher::CHUNK_LEN);
+	uint64_t total = 0;
+	while (true) {
+		size_t n = std::fread(buffer.data(), 1, buffer.size(), file);
+		hasher.append(buffer.data(), n);
+		total += n;
+		if (n < buffer.size())
+			break;
+	}
+	if (std::ferror(file))
+		return false;
+	
+	if (stats != nullptr) {
+		stats->bytes = total;
+		stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+	return true;
+}
+
+
+double FileHasher::Stats::getMegabytesPerSecond() const {
+	return seconds > 0 ? bytes / seconds / 1e6 : 0;
+}
+
+
+bool FileHasher::getSha256(const char *path, Sha256Hash &outHash, Stats *stats) {
+	assert(path != nullptr);
+	std::FILE *file = std::fopen(path, "rb");
+	if (file == nullptr)
+		return false;
+	bool result = getSha256(file, outHash, stats);
+	std::fclose(file);
+	return result;
+}
+
+
+bool FileHasher::getSha256(std::FILE *file, Sha256Hash &outHash, Stats *stats) {
+	static_assert(CHUNK_LEN % SHA256_BLOCK_LEN == 0, "Chunks must be whole blocks");
+	Sha256 hasher;
+	if (!appendStream(file, hasher, stats))
+		return false;
+	outHash = hasher.getHash();
+	return true;
+}
+
+
+bool FileHasher::getSha512(const char *path, uint8_t outHash[SHA512_HASH_LEN], Stats *stats) {
+	assert(path != nullptr);
+	std::FILE *file = std::fopen(path, "rb");
+	if (file == nullptr)
+		return false;
+	bool result = getSha512(file, outHash, stats);
+	std::fclose(file);
+	return result;
+}
+
+
+bool FileHasher::getSha512(std::FILE *file, uint8_t outHash[SHA512_HASH_LEN], Stats *stats) {
+	static_assert(CHUNK_LEN % SHA512_BLOCK_LEN == 0, "Chunks must be whole blocks");
+	assert(outHash != nullptr);
+	Sha512 hasher;
+	if (!appendStream(file, hasher, stats))
+		return false;
+	hasher.getHash(outHash);
+	return true;
+}
+
+
+bool FileHasher::getRipemd160(const char *path, uint8_t outHash[RIPEMD160_HASH_LEN], Stats *stats) {
+	assert(path != nullptr);
+	std::FILE *file = std::fopen(path, "rb");
+	if (file == nullptr)
+		return false;
+	bool result = getRipemd160(file, outHash, stats);
+	std::fclose(file);
+	return result;
+}
+
+
+bool FileHasher::getRipemd160(std::FILE *file, uint8_t outHash[RIPEMD160_HASH_LEN], Stats *stats) {
+	static_assert(CHUNK_LEN % RIPEMD160_BLOCK_LEN == 0, "Chunks must be whole blocks");
+	assert(outHash != nullptr);
+	Ripemd160 hasher;
+	if (!appendStream(file, hasher, stats))
+		return false;
+	hasher.getHash(outHash);
+	return true;
+}
@@ -0,0 +1,71 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include "Ripemd160.hpp"
+#include "Sha256Hash.hpp"
+#include "Sha512.hpp"
+
+
+/* 
+ * Hashes files and streams of any size, reading them in large chunks whose whole blocks
+ * are compressed directly from the read buffer. Provides just a few static methods.
+ */
+class FileHasher final {
+	
+public:
+	
+	// Statistics about one hashing run.
+	struct Stats final {
+		uint64_t bytes;   // Number of bytes hashed
+		double seconds;   // Elapsed wall-clock time
+		
+		// Returns the throughput in megabytes (10^6 bytes) per second, or 0 if no time elapsed.
+		double getMegabytesPerSecond() const;
+	};
+	
+	
+	// Computes the SHA-256 hash of the file at the given path. Returns true if the whole file was read,
+	// or false if it couldn't be opened or a read failed (in which case the outputs are unchanged).
+	// If stats is not null, then it receives the size and timing on success.
+	static bool getSha256(const char *path, Sha256Hash &outHash, Stats *stats=nullptr);
+	
+	
+	// Computes the SHA-256 hash of the rest of the given stream, which must be open for binary reading.
+	// Doesn't close the stream. Returns false if a read error occurred, with the same semantics as above.
+	static bool getSha256(std::FILE *file, Sha256Hash &outHash, Stats *stats=nullptr);
+	
+	
+	// Computes the SHA-512 hash of the file at the given path, with the same semantics as getSha256().
+	static bool getSha512(const char *path, uint8_t outHash[SHA512_HASH_LEN], Stats *stats=nullptr);
+	
+	
+	// Computes the SHA-512 hash of the rest of the given stream, with the same semantics as getSha256().
+	static bool getSha512(std::FILE *file, uint8_t outHash[SHA512_HASH_LEN], Stats *stats=nullptr);
+	
+	
+	// Computes the RIPEMD-160 hash of the file at the given path, with the same semantics as getSha256().
+	static bool getRipemd160(const char *path, uint8_t outHash[RIPEMD160_HASH_LEN], Stats *stats=nullptr);
+	
+	
+	// Computes the RIPEMD-160 hash of the rest of the given stream, with the same semantics as getSha256().
+	static bool getRipemd160(std::FILE *file, uint8_t outHash[RIPEMD160_HASH_LEN], Stats *stats=nullptr);
+	
+	
+	// The read size, a multiple of the hash block size so that no read leaves bytes buffered in the hasher.
+	static const size_t CHUNK_LEN = 1 << 20;
+	
+	
+private:
+	
+	FileHasher();  // Not instantiable
+	
+};
@@ -0,0 +1,176 @@
+/* 
+ * A runnable main program that tests the functionality of class FileHasher.
+ * 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include "TestHelper.hpp"
+#include <cstdio>
+#include <cstring>
+#include "FileHasher.hpp"
+#include "Ripemd160.hpp"
+#include "Sha256.hpp"
+#include "Sha256Hash.hpp"
+#include "Sha512.hpp"
+
+
+// Global variables
+static int numTestCases = 0;
+
+
+/*---- Helper functions ----*/
+
+// Returns a temporary binary stream holding the given bytes, positioned at the start.
+static std::FILE *makeStream(const Bytes &data) {
+	std::FILE *file = std::tmpfile();
+	assert(file != nullptr);
+	if (!data.empty())
+		assert(std::fwrite(data.data(), 1, data.size(), file) == data.size());
+	std::rewind(file);
+	return file;
+}
+
+
+/*---- Test cases ----*/
+
+static void testStreams() {
+	// One million 'a', and a pattern slightly longer than three read chunks
+	Bytes million(1000000, 'a');
+	Bytes pattern(3 * FileHasher::CHUNK_LEN + 100);
+	for (size_t i = 0; i < pattern.size(); i++)
+		pattern[i] = static_cast<uint8_t>(i * 7 + 3);
+	struct {
+		const Bytes &data;
+		const char *expectedHash;
+	} cases[] = {
+		{million, "D02C11C7CC396D040E2097A4489A80F1673ED784E2C7A18192FB14995C6EC7CD"},
+		{pattern, "AF6AED8CFF634F0087047F5AC3058E0EA9051C6FFA8F66368323B102E1160ED2"},
+	};
+	for (unsigned int i = 0; i < ARRAY_LENGTH(cases); i++) {
+		std::FILE *file = makeStream(cases[i].data);
+		Sha256Hash hash;
+		FileHasher::Stats stats;
+		assert(FileHasher::getSha256(file, hash, &stats));
+		std::fclose(file);
+		assert(hash == Sha256Hash(cases[i].expectedHash));
+		assert(stats.bytes == cases[i].data.size() && stats.seconds >= 0 && stats.getMegabytesPerSecond() >= 0);
+		numTestCases++;
+	}
+	
+	// Lengths around the block and chunk sizes
+	const size_t lengths[] = {0, 1, 63, 64, 65, FileHasher::CHUNK_LEN - 1, FileHasher::CHUNK_LEN, FileHasher::CHUNK_LEN + 1};
+	for (unsigned int i = 0; i < ARRAY_LENGTH(lengths); i++) {
+		Bytes data(pattern.begin(), pattern.begin() + lengths[i]);
+		std::FILE *file = makeStream(data);
+		Sha256Hash hash;
+		assert(FileHasher::getSha256(file, hash));
+		std::fclose(file);
+		assert(hash == Sha256::getHash(data.data(), data.size()));
+		numTestCases++;
+	}
+}
+
+
+static void testOtherHashes() {
+	// One million 'a', which spans one partial read chunk
+	{
+		Bytes million(1000000, 'a');
+		std::FILE *file = makeStream(million);
+		uint8_t hash512[SHA512_HASH_LEN];
+		FileHasher::Stats stats;
+		assert(FileHasher::getSha512(file, hash512, &stats));
+		assert(memcmp(hash512, hexBytes("E718483D0CE769644E2E42C7BC15B4638E1F98B13B2044285632A803AFA973EB"
+			"DE0FF244877EA60A4CB0432CE577C31BEB009C5C2C49AA2E4EADB217AD8CC09B").data(), SHA512_HASH_LEN) == 0);
+		assert(stats.bytes == million.size());
+		
+		std::rewind(file);
+		uint8_t hash160[RIPEMD160_HASH_LEN];
+		assert(FileHasher::getRipemd160(file, hash160, &stats));
+		assert(memcmp(hash160, hexBytes("52783243C1697BDBE16D37F97F68F08325DC1528").data(), RIPEMD160_HASH_LEN) == 0);
+		assert(stats.bytes == million.size());
+		std::fclose(file);
+		numTestCases++;
+	}
+	
+	// Lengths around the block and chunk sizes
+	const size_t lengths[] = {0, 1, 63, 64, 127, 128, 129, FileHasher::CHUNK_LEN - 1, FileHasher::CHUNK_LEN,
+		FileHasher::CHUNK_LEN + 1, 2 * FileHasher::CHUNK_LEN + 200};
+	for (unsigned int i = 0; i < ARRAY_LENGTH(lengths); i++) {
+		Bytes data(lengths[i]);
+		for (size_t j = 0; j < data.size(); j++)
+			data[j] = static_cast<uint8_t>(j * 11 + 5);
+		std::FILE *file = makeStream(data);
+		
+		uint8_t actual512[SHA512_HASH_LEN], expect512[SHA512_HASH_LEN];
+		assert(FileHasher::getSha512(file, actual512));
+		Sha512::getHash(data.data(), data.size(), expect512);
+		assert(memcmp(actual512, expect512, SHA512_HASH_LEN) == 0);
+		
+		std::rewind(file);
+		uint8_t actual160[RIPEMD160_HASH_LEN], expect160[RIPEMD160_HASH_LEN];
+		assert(FileHasher::getRipemd160(file, actual160));
+		Ripemd160::getHash(data.data(), data.size(), expect160);
+		assert(memcmp(actual160, expect160, RIPEMD160_HASH_LEN) == 0);
+		std::fclose(file);
+		numTestCases++;
+	}
+}
+
+
+static void testPaths() {
+	const char *path = "FileHasherTest.tmp";
+	const Bytes data(asciiBytes("abc"));
+	std::FILE *file = std::fopen(path, "wb");
+	assert(file != nullptr);
+	assert(std::fwrite(data.data(), 1, data.size(), file) == data.size());
+	std::fclose(file);
+	Sha256Hash hash;
+	assert(FileHasher::getSha256(path, hash));
+	assert(hash == Sha256Hash("AD1500F261FF10B49C7A1796A36103B02322AE5DDE404141EACF018FBF1678BA"));
+	assert(std::remove(path) == 0);
+	numTestCases++;
+	
+	const Sha256Hash before(hash);
+	assert(!FileHasher::getSha256(path, hash));
+	assert(hash == before);
+	numTestCases++;
+	
+	// The other hashes, through a path and for a missing file
+	file = std::fopen(path, "wb");
+	assert(file != nullptr);
+	assert(std::fwrite(data.data(), 1, data.size(), file) == data.size());
+	std::fclose(file);
+	uint8_t hash512[SHA512_HASH_LEN];
+	uint8_t hash160[RIPEMD160_HASH_LEN];
+	assert(FileHasher::getSha512(path, hash512));
+	assert(memcmp(hash512, hexBytes("DDAF35A193617ABACC417349AE20413112E6FA4E89A97EA20A9EEEE64B55D39A"
+		"2192992A274FC1A836BA3C23A3FEEBBD454D4423643CE80E2A9AC94FA54CA49F").data(), SHA512_HASH_LEN) == 0);
+	assert(FileHasher::getRipemd160(path, hash160));
+	assert(memcmp(hash160, hexBytes("8EB208F7E05D987A9B044A8E98C6B087F15A0BFC").data(), RIPEMD160_HASH_LEN) == 0);
+	assert(std::remove(path) == 0);
+	numTestCases++;
+	
+	uint8_t before512[SHA512_HASH_LEN];
+	uint8_t before160[RIPEMD160_HASH_LEN];
+	memcpy(before512, hash512, sizeof(hash512));
+	memcpy(before160, hash160, sizeof(hash160));
+	assert(!FileHasher::getSha512(path, hash512));
+	assert(!FileHasher::getRipemd160(path, hash160));
+	assert(memcmp(hash512, before512, sizeof(hash512)) == 0 && memcmp(hash160, before160, sizeof(hash160)) == 0);
+	numTestCases++;
+}
+
+
+/*---- Main runner ----*/
+
+int main(int argc, char **argv) {
+	testStreams();
+	testOtherHashes();
+	testPaths();
+	printf("All %d test cases passed\n", numTestCases);
+	return 0;
+}
@@ -0,0 +1,138 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include <cassert>
+#include <cstring>
+#include "Hash160.hpp"
+#include "Ripemd160.hpp"
+#include "Sha256.hpp"
+#include "Utils.hpp"
+
+
+static uint32_t reverseBytes32(uint32_t x);
+
+
+void Hash160::getHash(const uint8_t *msg, size_t len, uint8_t result[HASH160_LEN]) {
+	assert((msg != nullptr || len == 0) && result != nullptr);
+	const Sha256Hash shaHash(Sha256::getHash(msg, len));
+	Ripemd160::getHash(shaHash.value, SHA256_HASH_LEN, result);
+}
+
+
+void Hash160::getHash33(const uint8_t pubKey[33], uint8_t result[HASH160_LEN]) {
+	assert(pubKey != nullptr && result != nullptr);
+	uint8_t block[SHA256_BLOCK_LEN];
+	makeTailBlock(pubKey, 33, block);
+	uint32_t shaState[8];
+	memcpy(shaState, Sha256::INITIAL_STATE, sizeof(shaState));
+	Sha256::compress(shaState, block, SHA256_BLOCK_LEN);
+	
+	uint32_t words[16];
+	makeRipemdWords(shaState, words);
+	uint32_t state[5];
+	memcpy(state, Ripemd160::INITIAL_STATE, sizeof(state));
+	Ripemd160::compressWords(state, words);
+	stateToBytes(state, result);
+}
+
+
+void Hash160::getHash65(const uint8_t pubKey[65], uint8_t result[HASH160_LEN]) {
+	assert(pubKey != nullptr && result != nullptr);
+	uint32_t shaState[8];
+	memcpy(shaState, Sha256::INITIAL_STATE, sizeof(shaState));
+	Sha256::compress(shaState, pubKey, SHA256_BLOCK_LEN);
+	uint8_t block[SHA256_BLOCK_LEN];
+	makeTailBlock(&pubKey[SHA256_BLOCK_LEN], 65, block);
+	Sha256::compress(shaState, block, SHA256_BLOCK_LEN);
+	
+	uint32_t words[16];
+	makeRipemdWords(shaState, words);
+	uint32_t state[5];
+	memcpy(state, Ripemd160::INITIAL_STATE, sizeof(state));
+	Ripemd160::compressWords(state, words);
+	stateToBytes(state, result);
+}
+
+
+void Hash160::getHashMulti(const uint8_t pubKeys[], size_t keyLen, size_t len, uint8_t out[]) {
+	assert(keyLen == 33 || keyLen == 65);
+	assert((pubKeys != nullptr && out != nullptr) || len == 0);
+	const size_t CHUNK = 32;
+	uint32_t shaStates[CHUNK][8];
+	uint8_t blocks[CHUNK][SHA256_BLOCK_LEN];
+	uint32_t words[CHUNK][16];
+	uint32_t states[CHUNK][5];
+	uint32_t *statePtrs[CHUNK];
+	const uint8_t *blockPtrs[CHUNK];
+	const uint32_t *wordPtrs[CHUNK];
+	for (size_t i = 0; i < len; i += CHUNK) {
+		size_t n = len - i < CHUNK ? len - i : CHUNK;
+		
+		// SHA-256 of every key, where an uncompressed key's first block comes straight from the input
+		for (size_t j = 0; j < n; j++) {
+			const uint8_t *key = &pubKeys[(i + j) * keyLen];
+			memcpy(shaStates[j], Sha256::INITIAL_STATE, sizeof(shaStates[j]));
+			statePtrs[j] = shaStates[j];
+			blockPtrs[j] = key;
+		}
+		if (keyLen == 65)
+			Sha256::compressMulti(statePtrs, blockPtrs, n);
+		for (size_t j = 0; j < n; j++) {
+			const uint8_t *key = &pubKeys[(i + j) * keyLen];
+			makeTailBlock(&key[keyLen & ~static_cast<size_t>(SHA256_BLOCK_LEN - 1)], keyLen, blocks[j]);
+			blockPtrs[j] = blocks[j];
+		}
+		Sha256::compressMulti(statePtrs, blockPtrs, n);
+		
+		// RIPEMD-160 of every digest, passed along as words
+		for (size_t j = 0; j < n; j++) {
+			makeRipemdWords(shaStates[j], words[j]);
+			memcpy(states[j], Ripemd160::INITIAL_STATE, sizeof(states[j]));
+			statePtrs[j] = states[j];
+			wordPtrs[j] = words[j];
+		}
+		Ripemd160::compressWordsMulti(statePtrs, wordPtrs, n);
+		for (size_t j = 0; j < n; j++)
+			stateToBytes(states[j], &out[(i + j) * HASH160_LEN]);
+	}
+}
+
+
+void Hash160::makeTailBlock(const uint8_t *tail, size_t keyLen, uint8_t block[64]) {
+	size_t tailLen = keyLen % SHA256_BLOCK_LEN;
+	memset(block, 0, SHA256_BLOCK_LEN);
+	memcpy(block, tail, tailLen);
+	block[tailLen] = 0x80;
+	uint64_t bitLength = static_cast<uint64_t>(keyLen) << 3;  // 264 or 520, both below 2^16
+	block[SHA256_BLOCK_LEN - 2] = static_cast<uint8_t>(bitLength >> 8);
+	block[SHA256_BLOCK_LEN - 1] = static_cast<uint8_t>(bitLength >> 0);
+}
+
+
+void Hash160::makeRipemdWords(const uint32_t shaState[8], uint32_t words[16]) {
+	// The digest is the state in big endian, and RIPEMD-160 reads it back in little endian
+	for (int i = 0; i < 8; i++)
+		words[i] = reverseBytes32(shaState[i]);
+	words[8] = UINT32_C(0x00000080);  // Padding byte right after the 32-byte digest
+	for (int i = 9; i < 14; i++)
+		words[i] = 0;
+	words[14] = UINT32_C(256);  // Message length in bits, as a little-endian uint64
+	words[15] = 0;
+}
+
+
+void Hash160::stateToBytes(const uint32_t state[5], uint8_t result[HASH160_LEN]) {
+	// Uint32 array to bytes in little endian
+	for (int i = 0; i < HASH160_LEN; i++)
+		result[i] = static_cast<uint8_t>(state[i >> 2] >> ((i & 3) << 3));
+}
+
+
+static uint32_t reverseBytes32(uint32_t x) {
+	return (x << 24) | ((x & 0xFF00U) << 8) | ((x >> 8) & 0xFF00U) | (x >> 24);
+}
@@ -0,0 +1,61 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+
+/* 
+ * Computes HASH160(x) = RIPEMD-160(SHA-256(x)), which turns a serialized public key into the 20-byte
+ * hash inside a P2PKH or P2WPKH address. The 33-byte (compressed) and 65-byte (uncompressed) public key
+ * lengths have fused versions with hardcoded padding, where the SHA-256 state words become the
+ * RIPEMD-160 message words directly without a round trip through bytes. Provides just static methods.
+ */
+#define HASH160_LEN 20
+class Hash160 final {
+	
+public:
+	
+	// Computes the HASH160 of the given message of any length.
+	static void getHash(const uint8_t *msg, size_t len, uint8_t result[HASH160_LEN]);
+	
+	
+	// Computes the HASH160 of the given 33-byte compressed public key, using one SHA-256 compression.
+	static void getHash33(const uint8_t pubKey[33], uint8_t result[HASH160_LEN]);
+	
+	
+	// Computes the HASH160 of the given 65-byte uncompressed public key, using two SHA-256 compressions.
+	static void getHash65(const uint8_t pubKey[65], uint8_t result[HASH160_LEN]);
+	
+	
+	// Computes the HASH160 of each of len consecutive public keys, which are all keyLen bytes long (33 or 65), such that
+	// out[i * 20 : (i + 1) * 20] is the hash of pubKeys[i * keyLen : (i + 1) * keyLen]. Uses the multi-buffer
+	// compression functions of Sha256 and Ripemd160, which process several keys in parallel SIMD lanes if supported.
+	static void getHashMulti(const uint8_t pubKeys[], size_t keyLen, size_t len, uint8_t out[]);
+	
+	
+private:
+	
+	// Writes the SHA-256 block that ends a key of the given length (33 or 65) with its padding and length,
+	// given the key bytes after the last whole block (33 or 1 of them).
+	static void makeTailBlock(const uint8_t *tail, size_t keyLen, uint8_t block[64]);
+	
+	
+	// Converts the final SHA-256 state into the padded RIPEMD-160 block of the 32-byte digest, as message words.
+	static void makeRipemdWords(const uint32_t shaState[8], uint32_t words[16]);
+	
+	
+	// Serializes the final RIPEMD-160 state as the 20-byte hash.
+	static void stateToBytes(const uint32_t state[5], uint8_t result[HASH160_LEN]);
+	
+	
+	Hash160();  // Not instantiable
+	
+};
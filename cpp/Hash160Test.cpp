@@ -0,0 +1,87 @@
+/* 
+ * A runnable main program that tests the functionality of class Hash160.
+ * 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include "TestHelper.hpp"
+#include <cstdio>
+#include <cstring>
+#include "Hash160.hpp"
+
+
+// Global variables
+static int numTestCases = 0;
+
+
+/*---- Test cases ----*/
+
+static void testKnownHashes() {
+	struct TestCase {
+		const char *expectedHash;
+		const Bytes message;
+	};
+	TestCase cases[] = {
+		{"B472A266D0BD89C13706A4132CCFB16F7C3B9FCB", Bytes()},
+		{"751E76E8199196D454941C45D1B3A323F1433BD6", hexBytes("0279BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798")},
+		{"3442193E1BB70916E914552172CD4E2DBC9DF811", hexBytes("0339A36013301597DAEF41FBE593A02CC513D0B55527EC2DF1050E2E8FF49C85C2")},
+		{"91B24BF9F5288532960AC687ABB035127B1D28A5", hexBytes("0479BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8")},
+	};
+	for (unsigned int i = 0; i < ARRAY_LENGTH(cases); i++) {
+		const TestCase &tc = cases[i];
+		Bytes expected(hexBytes(tc.expectedHash));
+		uint8_t actual[HASH160_LEN];
+		Hash160::getHash(tc.message.data(), tc.message.size(), actual);
+		assert(memcmp(actual, expected.data(), HASH160_LEN) == 0);
+		if (tc.message.size() == 33) {
+			Hash160::getHash33(tc.message.data(), actual);
+			assert(memcmp(actual, expected.data(), HASH160_LEN) == 0);
+		} else if (tc.message.size() == 65) {
+			Hash160::getHash65(tc.message.data(), actual);
+			assert(memcmp(actual, expected.data(), HASH160_LEN) == 0);
+		}
+		numTestCases++;
+	}
+}
+
+
+static void testFusedAgainstGeneric() {
+	const size_t keyLens[] = {33, 65};
+	for (unsigned int i = 0; i < ARRAY_LENGTH(keyLens); i++) {
+		size_t keyLen = keyLens[i];
+		for (size_t count = 0; count <= 40; count += (count < 10 ? 1 : 15)) {
+			Bytes keys(count * keyLen);
+			for (size_t j = 0; j < keys.size(); j++)
+				keys[j] = static_cast<uint8_t>(j * 251 + count * 17 + keyLen);
+			Bytes hashes(count * HASH160_LEN);
+			Hash160::getHashMulti(keys.data(), keyLen, count, hashes.data());
+			for (size_t j = 0; j < count; j++) {
+				const uint8_t *key = &keys[j * keyLen];
+				uint8_t expected[HASH160_LEN];
+				uint8_t fused[HASH160_LEN];
+				Hash160::getHash(key, keyLen, expected);
+				if (keyLen == 33)
+					Hash160::getHash33(key, fused);
+				else
+					Hash160::getHash65(key, fused);
+				assert(memcmp(fused, expected, HASH160_LEN) == 0);
+				assert(memcmp(&hashes[j * HASH160_LEN], expected, HASH160_LEN) == 0);
+			}
+			numTestCases++;
+		}
+	}
+}
+
+
+/*---- Main runner ----*/
+
+int main(int argc, char **argv) {
+	testKnownHashes();
+	testFusedAgainstGeneric();
+	printf("All %d test cases passed\n", numTestCases);
+	return 0;
+}
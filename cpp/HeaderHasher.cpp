@@ -0,0 +1,236 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include <cassert>
+#include <cstring>
+#include "HeaderHasher.hpp"
+#include "Sha256.hpp"
+#include "Utils.hpp"
+
+
+static uint32_t readBigEndian32(const uint8_t *b);
+#ifdef USE_X86_INTRINSICS
+	static uint32_t reverseBytes32(uint32_t x);
+#endif
+
+
+/*---- Generic round helpers, for scalars and for GCC vector types ----*/
+
+// Rotates every 32-bit element right. Requires 1 <= i <= 31.
+#define ROTR(x, i)  (((x) >> (i)) | ((x) << (32 - (i))))
+
+
+// Performs SHA-256 round j with the given schedule word.
+template <typename T>
+static INLINE_LANES void roundStep(T &a, T &b, T &c, T &d, T &e, T &f, T &g, T &h, const T &w, int j) {
+	T t1 = h + (ROTR(e, 6) ^ ROTR(e, 11) ^ ROTR(e, 25)) + (g ^ (e & (f ^ g))) + Sha256::ROUND_CONSTANTS[j] + w;
+	T t2 = (ROTR(a, 2) ^ ROTR(a, 13) ^ ROTR(a, 22)) + ((a & (b | c)) | (b & c));
+	h = g;
+	g = f;
+	f = e;
+	e = d + t1;
+	d = c;
+	c = b;
+	b = a;
+	a = t1 + t2;
+}
+
+
+// Computes schedule word j (where j >= 16) in the ring of the last 16 words.
+template <typename T>
+static INLINE_LANES void expand(T schedule[16], int j) {
+	const T &w15 = schedule[(j - 15) & 15];
+	const T &w2 = schedule[(j - 2) & 15];
+	schedule[j & 15] += schedule[(j - 7) & 15]
+		+ (ROTR(w15,  7) ^ ROTR(w15, 18) ^ (w15 >>  3))
+		+ (ROTR(w2 , 17) ^ ROTR(w2 , 19) ^ (w2  >> 10));
+}
+
+
+/*---- HeaderHasher members ----*/
+
+HeaderHasher::HeaderHasher(const uint8_t header[BLOCK_HEADER_LEN]) {
+	assert(header != nullptr);
+	memcpy(midstate, Sha256::INITIAL_STATE, sizeof(midstate));
+	Sha256::compress(midstate, header, SHA256_BLOCK_LEN);
+	for (int i = 0; i < 3; i++)
+		blockWords[i] = readBigEndian32(&header[SHA256_BLOCK_LEN + i * 4]);
+	
+	// Rounds 0 to 2 of the second block
+	uint32_t a = midstate[0], b = midstate[1], c = midstate[2], d = midstate[3];
+	uint32_t e = midstate[4], f = midstate[5], g = midstate[6], h = midstate[7];
+	for (int j = 0; j < 3; j++)
+		roundStep(a, b, c, d, e, f, g, h, blockWords[j], j);
+	const uint32_t temp[8] = {a, b, c, d, e, f, g, h};
+	memcpy(roundState, temp, sizeof(roundState));
+	
+	// Words 16 and 17 depend only on words 0, 1, 2, 9, 10, 14, 15; the nonce is word 3
+	uint32_t schedule[16] = {blockWords[0], blockWords[1], blockWords[2], 0, UINT32_C(0x80000000),
+		0, 0, 0, 0, 0, 0, 0, 0, 0, 0, BLOCK_HEADER_LEN * 8};
+	expand(schedule, 16);
+	expand(schedule, 17);
+	schedule16 = schedule[0];
+	schedule17 = schedule[1];
+}
+
+
+Sha256Hash HeaderHasher::getHash(uint32_t nonce) const {
+	uint8_t block[SHA256_BLOCK_LEN] = {};
+	for (int i = 0; i < 12; i++)
+		block[i] = static_cast<uint8_t>(blockWords[i >> 2] >> ((3 - (i & 3)) << 3));
+	for (int i = 0; i < 4; i++)
+		block[12 + i] = static_cast<uint8_t>(nonce >> (i << 3));  // Little endian
+	block[16] = 0x80;
+	block[SHA256_BLOCK_LEN - 2] = (BLOCK_HEADER_LEN * 8) >> 8;
+	block[SHA256_BLOCK_LEN - 1] = (BLOCK_HEADER_LEN * 8) & 0xFF;
+	
+	uint32_t state[8];
+	memcpy(state, midstate, sizeof(state));
+	Sha256::compress(state, block, SHA256_BLOCK_LEN);
+	uint8_t firstHash[SHA256_HASH_LEN];
+	for (int i = 0; i < SHA256_HASH_LEN; i++)
+		firstHash[i] = static_cast<uint8_t>(state[i >> 2] >> ((3 - (i & 3)) << 3));
+	return Sha256::getHash(firstHash, sizeof(firstHash));
+}
+
+
+bool HeaderHasher::meetsTarget(uint32_t nonce, const Uint256 &target) const {
+	const Sha256Hash hash(getHash(nonce));
+	uint8_t bigEndian[SHA256_HASH_LEN];
+	for (int i = 0; i < SHA256_HASH_LEN; i++)
+		bigEndian[i] = hash.value[SHA256_HASH_LEN - 1 - i];
+	return Uint256(bigEndian) <= target;
+}
+
+
+bool HeaderHasher::scan(uint32_t startNonce, uint64_t count, const Uint256 &target, uint32_t &outNonce) const {
+	assert(count <= (UINT64_C(1) << 32) - startNonce);
+#ifdef USE_X86_INTRINSICS
+	static const bool useAvx2 = Utils::getCpuFeatures().avx2;  // Thread-safe initialization since C++11
+	if (useAvx2)
+		return scanAvx2(startNonce, count, target, outNonce);
+#endif
+	return scanSerial(startNonce, count, target, outNonce);
+}
+
+
+bool HeaderHasher::scanSerial(uint32_t startNonce, uint64_t count, const Uint256 &target, uint32_t &outNonce) const {
+	for (uint64_t i = 0; i < count; i++) {
+		uint32_t nonce = static_cast<uint32_t>(startNonce + i);
+		if (meetsTarget(nonce, target)) {
+			outNonce = nonce;
+			return true;
+		}
+	}
+	return false;
+}
+
+
+#ifdef USE_X86_INTRINSICS
+
+typedef uint32_t Uint32x8 __attribute__((vector_size(32)));
+
+
+// Hashes the 8 consecutive nonces starting at the given one, but runs the second hash only through round 60,
+// which fixes the final word 7 (the most significant word of the little-endian hash value). Returns the bit mask
+// of lanes whose most significant word is at most the target's, which are the only ones that can meet the target.
+static INLINE_LANES unsigned int filterLanes8(const uint32_t midstate[8], const uint32_t blockWords[3],
+		const uint32_t roundState[8], uint32_t schedule16, uint32_t schedule17, uint32_t firstNonce, uint32_t targetTop) {
+	typedef Uint32x8 Vec;
+	const int LANES = 8;
+	const Vec zero = {};
+	
+	// Second block of the first hash, resuming after round 2
+	Vec w[16];
+	for (int j = 0; j < 3; j++)
+		w[j] = zero + blockWords[j];
+	for (int k = 0; k < LANES; k++)
+		w[3][k] = reverseBytes32(firstNonce + static_cast<uint32_t>(k));
+	w[4] = zero + UINT32_C(0x80000000);
+	for (int j = 5; j < 15; j++)
+		w[j] = zero;
+	w[15] = zero + static_cast<uint32_t>(BLOCK_HEADER_LEN * 8);
+	Vec a = zero + roundState[0], b = zero + roundState[1], c = zero + roundState[2], d = zero + roundState[3];
+	Vec e = zero + roundState[4], f = zero + roundState[5], g = zero + roundState[6], h = zero + roundState[7];
+	for (int j = 3; j < 64; j++) {
+		if (j == 16)
+			w[0] = zero + schedule16;
+		else if (j == 17)
+			w[1] = zero + schedule17;
+		else if (j >= 18)
+			expand(w, j);
+		roundStep(a, b, c, d, e, f, g, h, w[j & 15], j);
+	}
+	
+	// Second hash, of the 32-byte first hash
+	w[0] = a + midstate[0];
+	w[1] = b + midstate[1];
+	w[2] = c + midstate[2];
+	w[3] = d + midstate[3];
+	w[4] = e + midstate[4];
+	w[5] = f + midstate[5];
+	w[6] = g + midstate[6];
+	w[7] = h + midstate[7];
+	w[8] = zero + UINT32_C(0x80000000);
+	for (int j = 9; j < 15; j++)
+		w[j] = zero;
+	w[15] = zero + static_cast<uint32_t>(SHA256_HASH_LEN * 8);
+	const uint32_t *iv = Sha256::INITIAL_STATE;
+	a = zero + iv[0]; b = zero + iv[1]; c = zero + iv[2]; d = zero + iv[3];
+	e = zero + iv[4]; f = zero + iv[5]; g = zero + iv[6]; h = zero + iv[7];
+	for (int j = 0; j <= 60; j++) {  // The e after round 60 becomes the final h
+		if (j >= 16)
+			expand(w, j);
+		roundStep(a, b, c, d, e, f, g, h, w[j & 15], j);
+	}
+	
+	unsigned int result = 0;
+	for (int k = 0; k < LANES; k++) {
+		if (reverseBytes32(e[k] + iv[7]) <= targetTop)
+			result |= 1U << k;
+	}
+	return result;
+}
+
+
+__attribute__((target("avx2")))
+bool HeaderHasher::scanAvx2(uint32_t startNonce, uint64_t count, const Uint256 &target, uint32_t &outNonce) const {
+	uint64_t i = 0;
+	for (; count - i >= 8; i += 8) {
+		uint32_t nonce = static_cast<uint32_t>(startNonce + i);
+		unsigned int candidates = filterLanes8(midstate, blockWords, roundState,
+			schedule16, schedule17, nonce, target.value[7]);
+		for (int k = 0; candidates != 0; k++, candidates >>= 1) {
+			if ((candidates & 1) != 0 && meetsTarget(nonce + static_cast<uint32_t>(k), target)) {
+				outNonce = nonce + static_cast<uint32_t>(k);
+				return true;
+			}
+		}
+	}
+	return scanSerial(static_cast<uint32_t>(startNonce + i), count - i, target, outNonce);
+}
+
+#endif
+
+
+#undef ROTR
+
+
+static uint32_t readBigEndian32(const uint8_t *b) {
+	return static_cast<uint32_t>(b[0]) << 24
+	     | static_cast<uint32_t>(b[1]) << 16
+	     | static_cast<uint32_t>(b[2]) <<  8
+	     | static_cast<uint32_t>(b[3]) <<  0;
+}
+
+
+#ifdef USE_X86_INTRINSICS
+static uint32_t reverseBytes32(uint32_t x) {
+	return (x << 24) | ((x & 0xFF00U) << 8) | ((x >> 8) & 0xFF00U) | (x >> 24);
+}
+#endif
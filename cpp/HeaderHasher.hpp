@@ -0,0 +1,69 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "Sha256Hash.hpp"
+#include "Uint256.hpp"
+
+
+/* 
+ * Computes the double SHA-256 hashes of an 80-byte block header under varying nonces. The first
+ * 64 header bytes are compressed once, and the rounds and schedule words of the second block that
+ * don't depend on the nonce are precomputed. Instances are immutable and can be shared by threads.
+ * Nothing here is constant-time, because block headers are public data.
+ */
+#define BLOCK_HEADER_LEN 80
+class HeaderHasher final {
+	
+	/*---- Fields ----*/
+	
+private:
+	uint32_t midstate[8];      // After compressing header bytes [0, 64)
+	uint32_t blockWords[3];    // Second block words 0 to 2: the end of the Merkle root, the time, and the bits
+	uint32_t roundState[8];    // Working variables after the second block's rounds 0 to 2, which precede the nonce
+	uint32_t schedule16;       // Second block schedule words 16 and 17, which don't depend on the nonce
+	uint32_t schedule17;
+	
+	
+	
+	/*---- Constructors ----*/
+public:
+	
+	// Prepares to hash the given header, whose nonce field (bytes [76, 80)) is ignored.
+	explicit HeaderHasher(const uint8_t header[BLOCK_HEADER_LEN]);
+	
+	
+	
+	/*---- Methods ----*/
+	
+	// Returns the block hash (double SHA-256) of the header with the given nonce.
+	Sha256Hash getHash(uint32_t nonce) const;
+	
+	
+	// Tests whether the header with the given nonce has a block hash that is at most the target,
+	// where the hash is read as a little-endian 256-bit integer.
+	bool meetsTarget(uint32_t nonce, const Uint256 &target) const;
+	
+	
+	// Scans the nonces [startNonce, startNonce + count) in increasing order. If some nonce meets the target,
+	// then outNonce is set to the first such nonce and true is returned; otherwise outNonce is unchanged and
+	// false is returned. Requires startNonce + count <= 2^32. Uses parallel SIMD lanes if supported.
+	bool scan(uint32_t startNonce, uint64_t count, const Uint256 &target, uint32_t &outNonce) const;
+	
+	
+private:
+	
+	bool scanSerial(uint32_t startNonce, uint64_t count, const Uint256 &target, uint32_t &outNonce) const;
+	
+	// Only defined if USE_X86_INTRINSICS is defined.
+	bool scanAvx2(uint32_t startNonce, uint64_t count, const Uint256 &target, uint32_t &outNonce) const;
+	
+};
@@ -0,0 +1,104 @@
+/* 
+ * A runnable main program that tests the functionality of class HeaderHasher.
+ * 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include "TestHelper.hpp"
+#include <cstdio>
+#include "HeaderHasher.hpp"
+#include "Sha256.hpp"
+#include "Sha256Hash.hpp"
+#include "Uint256.hpp"
+
+
+// Global variables
+static int numTestCases = 0;
+static const Bytes genesisHeader(hexBytes("0100000000000000000000000000000000000000000000000000000000000000000000003BA3EDFD7A7B12B27AC72C3E67768F617FC81BC3888A51323A9FB8AA4B1E5E4A29AB5F49FFFF001D1DAC2B7C"));
+static const uint32_t GENESIS_NONCE = UINT32_C(2083236893);
+
+
+/*---- Test cases ----*/
+
+static void testGenesisBlock() {
+	const HeaderHasher hasher(genesisHeader.data());
+	assert(hasher.getHash(GENESIS_NONCE) == Sha256Hash("000000000019D6689C085AE165831E934FF763AE46A2A6C172B3F1B60A8CE26F"));
+	const Uint256 target("00000000FFFF0000000000000000000000000000000000000000000000000000");  // Bits 0x1D00FFFF
+	assert(hasher.meetsTarget(GENESIS_NONCE, target));
+	assert(!hasher.meetsTarget(GENESIS_NONCE + 1, target));
+	numTestCases++;
+	
+	for (uint32_t before = 0; before <= 300; before += 7) {
+		for (uint32_t after = 0; after <= 20; after += 5) {
+			uint32_t nonce = 0;
+			assert(hasher.scan(GENESIS_NONCE - before, before + after + 1, target, nonce));
+			assert(nonce == GENESIS_NONCE);
+			numTestCases++;
+		}
+	}
+	
+	uint32_t nonce = 1;
+	assert(!hasher.scan(GENESIS_NONCE - 300, 300, target, nonce) && nonce == 1);
+	numTestCases++;
+}
+
+
+static void testAgainstGenericHash() {
+	Bytes header(genesisHeader);
+	for (uint32_t nonce = 0; nonce < 300; nonce += 13) {
+		for (int i = 0; i < 4; i++)
+			header[76 + i] = static_cast<uint8_t>(nonce >> (i * 8));
+		const HeaderHasher hasher(header.data());
+		assert(hasher.getHash(nonce) == Sha256::getDoubleHash(header.data(), header.size()));
+		header[nonce % 76] ^= 0x5A;  // Vary the nonce-independent part too
+		numTestCases++;
+	}
+}
+
+
+static void testScanFindsFirst() {
+	const HeaderHasher hasher(genesisHeader.data());
+	uint32_t nonce = 0;
+	assert(hasher.scan(0, 10000, Uint256("000FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"), nonce));
+	assert(nonce == 4200);
+	assert(hasher.getHash(nonce) == Sha256Hash("00055472F907066521D4F41ABD2D1B3CBC102C78C60A153C296771793C50921B"));
+	numTestCases++;
+	
+	// Easy targets where many nonces pass, compared with brute force, including at the end of the nonce range
+	const Uint256 targets[] = {
+		Uint256("7FFFFF0000000000000000000000000000000000000000000000000000000000"),  // Bits 0x207FFFFF, as in regtest
+		Uint256("0FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"),
+		Uint256("00FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"),
+	};
+	const uint32_t starts[] = {0, 5, 1000, UINT32_C(0xFFFFFFFF) - 600};
+	for (unsigned int i = 0; i < ARRAY_LENGTH(targets); i++) {
+		for (unsigned int j = 0; j < ARRAY_LENGTH(starts); j++) {
+			uint64_t count = 601;
+			uint32_t expect = 0;
+			bool expectFound = false;
+			for (uint64_t k = 0; k < count && !expectFound; k++) {
+				expect = static_cast<uint32_t>(starts[j] + k);
+				expectFound = hasher.meetsTarget(expect, targets[i]);
+			}
+			uint32_t actual = 0;
+			assert(hasher.scan(starts[j], count, targets[i], actual) == expectFound);
+			assert(!expectFound || actual == expect);
+			numTestCases++;
+		}
+	}
+}
+
+
+/*---- Main runner ----*/
+
+int main(int argc, char **argv) {
+	testGenesisBlock();
+	testAgainstGenericHash();
+	testScanFindsFirst();
+	printf("All %d test cases passed\n", numTestCases);
+	return 0;
+}
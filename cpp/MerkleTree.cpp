@@ -0,0 +1,109 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include <cassert>
+#include <cstring>
+#include <vector>
+#include "MerkleTree.hpp"
+#include "Sha256.hpp"
+
+
+Sha256Hash MerkleTree::computeRoot(const Sha256Hash leaves[], size_t len, bool *mutated) {
+	assert(leaves != nullptr || len == 0);
+	if (len <= 1) {
+		if (mutated != nullptr)
+			*mutated = false;
+		return len == 0 ? Sha256Hash() : leaves[0];
+	}
+	
+	// A single allocation serves the whole tree: the first level
+	// is reduced into the workspace, and the rest are reduced in place
+	std::vector<Sha256Hash> work((len + 1) / 2);
+	bool firstMutated = false;
+	size_t n = reduceLevel(leaves, len, work.data(), firstMutated);
+	bool restMutated;
+	const Sha256Hash result = computeRootInPlace(work.data(), n, &restMutated);
+	if (mutated != nullptr)
+		*mutated = firstMutated || restMutated;
+	return result;
+}
+
+
+Sha256Hash MerkleTree::computeRootInPlace(Sha256Hash hashes[], size_t len, bool *mutated) {
+	assert(hashes != nullptr || len == 0);
+	bool mut = false;
+	while (len > 1)
+		len = reduceLevel(hashes, len, hashes, mut);
+	if (mutated != nullptr)
+		*mutated = mut;
+	return len == 0 ? Sha256Hash() : hashes[0];
+}
+
+
+size_t MerkleTree::computeBranch(const Sha256Hash leaves[], size_t len, size_t index, Sha256Hash outBranch[]) {
+	assert(leaves != nullptr && index < len && outBranch != nullptr);
+	std::vector<Sha256Hash> work((len + 1) / 2);
+	const Sha256Hash *level = leaves;
+	size_t branchLen = 0;
+	bool mutated = false;  // Not reported
+	while (len > 1) {
+		size_t sibling = index ^ 1;
+		outBranch[branchLen] = level[sibling < len ? sibling : index];
+		branchLen++;
+		len = reduceLevel(level, len, work.data(), mutated);
+		level = work.data();
+		index >>= 1;
+	}
+	return branchLen;
+}
+
+
+Sha256Hash MerkleTree::computeRootFromBranch(const Sha256Hash &leaf, const Sha256Hash branch[], size_t branchLen, size_t index) {
+	assert(branch != nullptr || branchLen == 0);
+	Sha256Hash result(leaf);
+	for (size_t i = 0; i < branchLen; i++, index >>= 1) {
+		if ((index & 1) == 0)
+			result = hashPair(result, branch[i]);
+		else
+			result = hashPair(branch[i], result);
+	}
+	return result;
+}
+
+
+bool MerkleTree::verifyBranch(const Sha256Hash &leaf, const Sha256Hash branch[], size_t branchLen, size_t index, const Sha256Hash &root) {
+	assert(branch != nullptr || branchLen == 0);
+	if (branchLen < sizeof(index) * 8 && (index >> branchLen) != 0)
+		return false;
+	return computeRootFromBranch(leaf, branch, branchLen, index) == root;
+}
+
+
+size_t MerkleTree::reduceLevel(const Sha256Hash nodes[], size_t len, Sha256Hash out[], bool &mutated) {
+	static_assert(sizeof(Sha256Hash) == SHA256_HASH_LEN, "Arrays of hashes must be contiguous bytes");
+	size_t pairs = len / 2;
+	for (size_t i = 0; i < pairs; i++) {
+		if (nodes[i * 2] == nodes[i * 2 + 1])
+			mutated = true;
+	}
+	
+	// Each pair of adjacent nodes is one 64-byte message. The in-place output of pair i
+	// overwrites nodes at most up to index i, which every pair before it has already read.
+	Sha256::getDoubleHash64Multi(reinterpret_cast<const uint8_t*>(nodes), pairs, out);
+	if (len % 2 == 1)
+		out[pairs] = hashPair(nodes[len - 1], nodes[len - 1]);
+	return pairs + len % 2;
+}
+
+
+Sha256Hash MerkleTree::hashPair(const Sha256Hash &left, const Sha256Hash &right) {
+	uint8_t block[SHA256_HASH_LEN * 2];
+	memcpy(&block[0], left.value, SHA256_HASH_LEN);
+	memcpy(&block[SHA256_HASH_LEN], right.value, SHA256_HASH_LEN);
+	return Sha256::getDoubleHash64(block);
+}
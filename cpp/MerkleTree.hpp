@@ -0,0 +1,63 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#pragma once
+
+#include <cstddef>
+#include "Sha256Hash.hpp"
+
+
+/* 
+ * Computes Bitcoin Merkle tree roots and branches over arrays of double SHA-256 hashes (such as txids).
+ * Each parent node is the double SHA-256 of its two children concatenated, and a level with an odd number
+ * of nodes pairs its last node with itself. Provides just a few static methods. Nothing here is constant-time,
+ * because Merkle trees are built from public data.
+ */
+class MerkleTree final {
+	
+public:
+	
+	// Returns the Merkle root of the given leaf hashes, or the all-zero hash if len is 0. The leaves array is not modified.
+	// If mutated is not null, then it is set to whether some level paired two identical adjacent nodes; such a tree has the
+	// same root as a different list of leaves (CVE-2012-2459), so a block with a mutated tree must be rejected as invalid.
+	static Sha256Hash computeRoot(const Sha256Hash leaves[], size_t len, bool *mutated=nullptr);
+	
+	
+	// Like computeRoot(), but uses the given array as the workspace, destroying its contents. Needs no extra memory.
+	static Sha256Hash computeRootInPlace(Sha256Hash hashes[], size_t len, bool *mutated=nullptr);
+	
+	
+	// Writes the Merkle branch of the leaf at the given index, which is the sibling node at every level from the bottom up,
+	// and returns the branch length. The outBranch array must have room for ceil(log2(len)) hashes (64 always suffices).
+	// Requires index < len.
+	static size_t computeBranch(const Sha256Hash leaves[], size_t len, size_t index, Sha256Hash outBranch[]);
+	
+	
+	// Returns the Merkle root implied by the given leaf, the branch that came from computeBranch(), and the leaf's index.
+	static Sha256Hash computeRootFromBranch(const Sha256Hash &leaf, const Sha256Hash branch[], size_t branchLen, size_t index);
+	
+	
+	// Tests whether the given leaf at the given index is in the tree with the given root, according to the branch.
+	// Returns false if the index needs more levels than the branch has.
+	static bool verifyBranch(const Sha256Hash &leaf, const Sha256Hash branch[], size_t branchLen, size_t index, const Sha256Hash &root);
+	
+	
+private:
+	
+	// Replaces the given level of nodes with its parent level, returning the number of parent nodes.
+	// The output array may be the same as the input array. Sets mutated to true if two real siblings are equal.
+	static size_t reduceLevel(const Sha256Hash nodes[], size_t len, Sha256Hash out[], bool &mutated);
+	
+	
+	// Returns the double SHA-256 hash of the concatenation of the two given nodes.
+	static Sha256Hash hashPair(const Sha256Hash &left, const Sha256Hash &right);
+	
+	
+	MerkleTree();  // Not instantiable
+	
+};
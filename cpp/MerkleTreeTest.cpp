@@ -0,0 +1,160 @@
+/* 
+ * A runnable main program that tests the functionality of class MerkleTree.
+ * 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include "TestHelper.hpp"
+#include <cstdio>
+#include "MerkleTree.hpp"
+#include "Sha256.hpp"
+#include "Sha256Hash.hpp"
+
+
+// Global variables
+static int numTestCases = 0;
+
+
+/*---- Helper functions ----*/
+
+// Returns the root by the straightforward definition, duplicating the last node of each odd level.
+static Sha256Hash naiveRoot(std::vector<Sha256Hash> level) {
+	if (level.empty())
+		return Sha256Hash();
+	while (level.size() > 1) {
+		if (level.size() % 2 == 1)
+			level.push_back(level.back());
+		std::vector<Sha256Hash> next;
+		for (size_t i = 0; i < level.size(); i += 2) {
+			uint8_t pair[SHA256_HASH_LEN * 2];
+			memcpy(&pair[0], level[i].value, SHA256_HASH_LEN);
+			memcpy(&pair[SHA256_HASH_LEN], level[i + 1].value, SHA256_HASH_LEN);
+			const Sha256Hash innerHash(Sha256::getHash(pair, sizeof(pair)));
+			next.push_back(Sha256::getHash(innerHash.value, SHA256_HASH_LEN));
+		}
+		level = next;
+	}
+	return level[0];
+}
+
+
+static std::vector<Sha256Hash> makeLeaves(size_t len) {
+	std::vector<Sha256Hash> result;
+	for (size_t i = 0; i < len; i++) {
+		uint8_t msg[2] = {static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8)};
+		result.push_back(Sha256::getHash(msg, sizeof(msg)));
+	}
+	return result;
+}
+
+
+/*---- Test cases ----*/
+
+static void testKnownRoots() {
+	// Block 100000
+	const Sha256Hash txids[] = {
+		Sha256Hash("8C14F0DB3DF150123E6F3DBBF30F8B955A8249B62AC1D1FF16284AEFA3D06D87"),
+		Sha256Hash("FFF2525B8931402DD09222C50775608F75787BD2B87E56995A7BDD30F79702C4"),
+		Sha256Hash("6359F0868171B1D194CBEE1AF2F16EA598AE8FAD666D9B012C8ED2B79A236EC4"),
+		Sha256Hash("E9A66845E05D5ABC0AD04EC80F774A7E585C6E8DB975962D069A522137B80C1D"),
+	};
+	bool mutated = true;
+	assert(MerkleTree::computeRoot(txids, ARRAY_LENGTH(txids), &mutated) == Sha256Hash("F3E94742ACA4B5EF85488DC37C06C3282295FFEC960994B2C0D5AC2A25A95766"));
+	assert(!mutated);
+	numTestCases++;
+	
+	// Five leaves, each the SHA-256 of one byte from 0 to 4
+	const Sha256Hash leaves[] = {
+		Sha256Hash("1DA0AF1706A31185763837B33F1D90782C0A78BBE644A59C987AB3FF9C0B346E"),
+		Sha256Hash("9A4585773CE2CCD7A585C331D60A60D1E3B7D28CBB2EDE3BC55445342F12F54B"),
+		Sha256Hash("86D9576498EA764B49243EFEB05DF625010438C6A55D5B578DE4FF00C9B4C1DB"),
+		Sha256Hash("C529FFAD9A5AB61162B11D616B639E00586BA846746A197D4DAF78B908ED4F08"),
+		Sha256Hash("719EC881A39CA062F09262FF75FC8A06D6CB91AD078C4D344723508C509C2DE5"),
+	};
+	assert(MerkleTree::computeRoot(leaves, ARRAY_LENGTH(leaves)) == Sha256Hash("D0309406AA8BB865EF8784B803C831F6B2DF9914F5B809AD1D403E3E4E7370F5"));
+	numTestCases++;
+	
+	// Single leaf and empty tree
+	assert(MerkleTree::computeRoot(txids, 1) == txids[0]);
+	assert(MerkleTree::computeRoot(nullptr, 0) == Sha256Hash());
+	numTestCases++;
+}
+
+
+static void testAgainstNaive() {
+	for (size_t len = 0; len <= 70; len++) {
+		std::vector<Sha256Hash> leaves(makeLeaves(len));
+		const Sha256Hash expect(naiveRoot(leaves));
+		bool mutated = true;
+		assert(MerkleTree::computeRoot(leaves.data(), len, &mutated) == expect);
+		assert(!mutated);
+		std::vector<Sha256Hash> work(leaves);
+		mutated = true;
+		assert(MerkleTree::computeRootInPlace(work.data(), len, &mutated) == expect);
+		assert(!mutated);
+		numTestCases++;
+	}
+}
+
+
+static void testMutation() {
+	// Duplicating the last leaf of an odd level keeps the root but must be detected
+	for (size_t len = 3; len <= 21; len += 2) {
+		std::vector<Sha256Hash> leaves(makeLeaves(len));
+		bool mutated = true;
+		const Sha256Hash root(MerkleTree::computeRoot(leaves.data(), leaves.size(), &mutated));
+		assert(!mutated);
+		leaves.push_back(leaves.back());
+		assert(MerkleTree::computeRoot(leaves.data(), leaves.size(), &mutated) == root);
+		assert(mutated);
+		numTestCases++;
+	}
+	
+	// Equal siblings at a higher level
+	std::vector<Sha256Hash> leaves(makeLeaves(6));
+	leaves.push_back(leaves[4]);
+	leaves.push_back(leaves[5]);
+	bool mutated = false;
+	MerkleTree::computeRoot(leaves.data(), leaves.size(), &mutated);
+	assert(mutated);
+	numTestCases++;
+}
+
+
+static void testBranches() {
+	for (size_t len = 1; len <= 40; len++) {
+		std::vector<Sha256Hash> leaves(makeLeaves(len));
+		const Sha256Hash root(MerkleTree::computeRoot(leaves.data(), len));
+		size_t expectBranchLen = 0;
+		while ((static_cast<size_t>(1) << expectBranchLen) < len)
+			expectBranchLen++;
+		for (size_t i = 0; i < len; i++) {
+			Sha256Hash branch[64];
+			size_t branchLen = MerkleTree::computeBranch(leaves.data(), len, i, branch);
+			assert(branchLen == expectBranchLen);
+			assert(MerkleTree::computeRootFromBranch(leaves[i], branch, branchLen, i) == root);
+			assert(MerkleTree::verifyBranch(leaves[i], branch, branchLen, i, root));
+			if (len > 1) {
+				assert(!MerkleTree::verifyBranch(leaves[(i + 1) % len], branch, branchLen, i, root));
+				assert(!MerkleTree::verifyBranch(leaves[i], branch, branchLen, i + (static_cast<size_t>(1) << branchLen), root));
+			}
+			numTestCases++;
+		}
+	}
+}
+
+
+/*---- Main runner ----*/
+
+int main(int argc, char **argv) {
+	testKnownRoots();
+	testAgainstNaive();
+	testMutation();
+	testBranches();
+	printf("All %d test cases passed\n", numTestCases);
+	return 0;
+}
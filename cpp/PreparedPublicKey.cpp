@@ -0,0 +1,41 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include "PreparedPublicKey.hpp"
+
+
+PreparedPublicKey::PreparedPublicKey(const CurvePoint &publicKey) :
+		point(publicKey),
+		valid(isValidPoint(publicKey)),
+		table(publicKey) {
+	table.normalize();
+}
+
+
+bool PreparedPublicKey::isValid() const {
+	return valid;
+}
+
+
+const CurvePoint &PreparedPublicKey::getPoint() const {
+	return point;
+}
+
+
+const CurvePoint::MultiplesTable &PreparedPublicKey::getTable() const {
+	return table;
+}
+
+
+bool PreparedPublicKey::isValidPoint(const CurvePoint &publicKey) {
+	if (publicKey.isZero() || publicKey.z != CurvePoint::FI_ONE || !publicKey.isOnCurve())
+		return false;
+	CurvePoint q(publicKey);
+	q.multiply(CurvePoint::ORDER);
+	return q.isZero();
+}
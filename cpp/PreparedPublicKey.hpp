@@ -0,0 +1,60 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#pragma once
+
+#include "CurvePoint.hpp"
+
+
+/* 
+ * A public key that has been validated once, together with its precomputed table of multiples
+ * in normalized (affine) form. Ecdsa::verify() accepts instances of this class, so that verifying
+ * many signatures against the same key skips the point validation and table building on every call.
+ * Instances of this class are immutable.
+ */
+class PreparedPublicKey final {
+	
+	/*---- Fields ----*/
+	
+private:
+	CurvePoint point;
+	bool valid;
+	CurvePoint::MultiplesTable table;
+	
+	
+	
+	/*---- Constructors ----*/
+public:
+	
+	// Validates the given public key and precomputes its table of multiples. The point must be normalized.
+	// If the point is not a valid public key, then the object is still constructed but isValid() returns false.
+	explicit PreparedPublicKey(const CurvePoint &publicKey);
+	
+	
+	
+	/*---- Methods ----*/
+	
+	// Returns whether the public key given at construction passed validation.
+	bool isValid() const;
+	
+	
+	// Returns the public key point given at construction.
+	const CurvePoint &getPoint() const;
+	
+	
+	// Returns the normalized table of multiples of the public key point.
+	const CurvePoint::MultiplesTable &getTable() const;
+	
+	
+	/*---- Static functions ----*/
+	
+	// Tests whether the given point is usable as an ECDSA public key: It must be normalized, not zero,
+	// on the curve, and yield zero when multiplied by CurvePoint::ORDER. Not constant-time.
+	static bool isValidPoint(const CurvePoint &publicKey);
+	
+};
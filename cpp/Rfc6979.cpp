@@ -0,0 +1,69 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include <cassert>
+#include <cstring>
+#include "Rfc6979.hpp"
+#include "CurvePoint.hpp"
+#include "Sha256.hpp"
+#include "Utils.hpp"
+
+
+Rfc6979::Rfc6979(const Uint256 &privateKey, const Sha256Hash &msgHash) :
+		hmacKey(nullptr, 0),  // K = 0x00 0x00 ... 0x00, because a short key is zero-padded to a block
+		hasCandidate(false) {
+	assert((Uint256::ZERO < privateKey) & (privateKey < CurvePoint::ORDER));
+	
+	// extra = int2octets(privateKey) || bits2octets(msgHash)
+	uint8_t extra[64];
+	privateKey.getBigEndianBytes(&extra[0]);
+	Uint256 h1(msgHash.value);
+	h1.subtract(CurvePoint::ORDER, static_cast<uint32_t>(h1 >= CurvePoint::ORDER));
+	h1.getBigEndianBytes(&extra[32]);
+	
+	// V = 0x01 0x01 ... 0x01
+	memset(v, 0x01, sizeof(v));
+	
+	update(0x00, extra, sizeof(extra));
+	update(0x01, extra, sizeof(extra));
+}
+
+
+Uint256 Rfc6979::nextNonce() {
+	while (true) {
+		if (hasCandidate)  // The previous candidate was rejected
+			update(0x00, nullptr, 0);
+		updateV();
+		hasCandidate = true;
+		Uint256 k(v);
+		if ((Uint256::ZERO < k) & (k < CurvePoint::ORDER))
+			return k;
+	}
+}
+
+
+void Rfc6979::update(uint8_t sep, const uint8_t *extra, size_t extraLen) {
+	assert((extra != nullptr || extraLen == 0) && extraLen <= 64);
+	uint8_t msg[SHA256_HASH_LEN + 1 + 64];
+	memcpy(msg, v, SHA256_HASH_LEN);
+	msg[SHA256_HASH_LEN] = sep;
+	Utils::copyBytes(&msg[SHA256_HASH_LEN + 1], extra, extraLen);
+	setKey(Sha256::getHmac(hmacKey, msg, SHA256_HASH_LEN + 1 + extraLen));
+	updateV();
+}
+
+
+void Rfc6979::setKey(const Sha256Hash &key) {
+	hmacKey = HmacSha256Key(key.value, SHA256_HASH_LEN);
+}
+
+
+void Rfc6979::updateV() {
+	const Sha256Hash newV(Sha256::getHmac(hmacKey, v, sizeof(v)));
+	memcpy(v, newV.value, sizeof(v));
+}
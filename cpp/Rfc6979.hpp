@@ -0,0 +1,65 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "Sha256.hpp"
+#include "Sha256Hash.hpp"
+#include "Uint256.hpp"
+
+
+/* 
+ * Generates deterministic ECDSA nonces for secp256k1 as specified in RFC 6979, using HMAC-SHA-256.
+ * The HMAC key states for the current value of K are kept, so each update of V costs only
+ * two SHA-256 compressions instead of rekeying. Instances of this class are mutable and hold secret data.
+ */
+class Rfc6979 final {
+	
+	/*---- Fields ----*/
+	
+private:
+	HmacSha256Key hmacKey;  // Keyed by K
+	uint8_t v[SHA256_HASH_LEN];
+	bool hasCandidate;  // Whether nextNonce() has returned a value before
+	
+	
+	
+	/*---- Constructors ----*/
+public:
+	
+	// Initializes the generator for the given private key and message hash (RFC 6979 section 3.2 steps a to g).
+	// The private key must be in the range [1, CurvePoint::ORDER). The message hash is interpreted
+	// in big endian, the same way as in Ecdsa::sign(). Constant-time with respect to the values.
+	Rfc6979(const Uint256 &privateKey, const Sha256Hash &msgHash);
+	
+	
+	
+	/*---- Methods ----*/
+	
+	// Returns the next candidate nonce, which is in the range [1, CurvePoint::ORDER) (RFC 6979 section 3.2 step h).
+	// The first call returns the standard nonce; each later call returns the nonce that would be tried
+	// after the previous one was rejected. Constant-time when no candidate needs to be skipped.
+	Uint256 nextNonce();
+	
+	
+private:
+	
+	// Sets K = HMAC_K(V || sep || extra), then V = HMAC_K(V).
+	void update(uint8_t sep, const uint8_t *extra, size_t extraLen);
+	
+	
+	// Sets the HMAC key context for the given new value of K.
+	void setKey(const Sha256Hash &key);
+	
+	
+	// Sets V = HMAC_K(V).
+	void updateV();
+	
+};
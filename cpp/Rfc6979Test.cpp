@@ -0,0 +1,89 @@
+/* 
+ * A runnable main program that tests the functionality of class Rfc6979,
+ * and of the RFC 6979 signing method in class Ecdsa.
+ * 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include "TestHelper.hpp"
+#include <cstdio>
+#include "CurvePoint.hpp"
+#include "Ecdsa.hpp"
+#include "Rfc6979.hpp"
+#include "Sha256.hpp"
+#include "Sha256Hash.hpp"
+#include "Uint256.hpp"
+
+
+/*---- Structures ----*/
+
+struct TestCase {
+	const char *privateKey;
+	const Bytes msgHash;  // In natural byte order
+	const char *nonce0;
+	const char *nonce1;
+	const char *expectedR;
+	const char *expectedS;
+};
+
+
+static Bytes sha256Bytes(const char *str) {
+	const Bytes msg(asciiBytes(str));
+	const Sha256Hash hash(Sha256::getHash(msg.data(), msg.size()));
+	return Bytes(hash.value, hash.value + SHA256_HASH_LEN);
+}
+
+
+/*---- Test suite ----*/
+
+int main(int argc, char **argv) {
+	int numTestCases = 0;
+	
+	TestCase cases[] = {
+		{"0000000000000000000000000000000000000000000000000000000000000001", sha256Bytes("Satoshi Nakamoto"),
+			"8F8A276C19F4149656B280621E358CCE24F5F52542772691EE69063B74F15D15", "F15FB763A6BCBBACBDE0A6A9AE2A02482BD92F3E75A50B357BD551DDD771045E",
+			"934B1EA10A4B3C1757E2B0C017D0B6143CE3C9A7E6A4A49860D7A6AB210EE3D8", "2442CE9D2B916064108014783E923EC36B49743E2FFA1C4496F01A512AAFD9E5"},
+		{"0000000000000000000000000000000000000000000000000000000000000001", sha256Bytes("All those moments will be lost in time, like tears in rain. Time to die..."),
+			"38AA22D72376B4DBC472E06C3BA403EE0A394DA63FC58D88686C611ABA98D6B3", "DC5417A2ADA98871B9EE7DB9E12E62E7283F6FC0E18A1C1B161E7E75A64034BA",
+			"8600DBD41E348FE5C9465AB92D23E3DB8B98B873BEECD930736488696438CB6B", "547FE64427496DB33BF66019DACBF0039C04199ABB0122918601DB38A72CFC21"},
+		{"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364140", sha256Bytes("Satoshi Nakamoto"),
+			"33A19B60E25FB6F4435AF53A3D42D493644827367E6453928554F43E49AA6F90", "635653806D2B851EDB5EB4A3E0098AD6DF9CF16447DC19530C33854E78A5C964",
+			"FD567D121DB66E382991534ADA77A6BD3106F0A1098C231E47993447CD6AF2D0", "6B39CD0EB1BC8603E159EF5C20A5C8AD685A45B06CE9BEBED3F153D10D93BED5"},
+		{"F8B8AF8CE3C7CCA5E300D33939540C10D45CE001B8F252BFBC57BA0342904181", sha256Bytes("Alan Turing"),
+			"525A82B70E67874398067543FD84C83D30C175FDC45FDEEE082FE13B1D7CFDF1", "7FD11AA3DB66AD20C832D3DF288D33982ACA50B1CD436880B44D839819087A84",
+			"7063AE83E7F62BBB171798131B4A0564B956930092B33B07B395615D9EC7E15C", "58DFCC1E00A35E1572F366FFE34BA0FC47DB1E7189759B9FB233C5B05AB388EA"},
+		{"E91671C46231F833A6406CCBEA0E3E392C76C167BAC1CB013F6F1013980455C2", sha256Bytes("There is a computer disease that anybody who works with computers knows about. It's a very serious disease and it interferes completely with the work. The trouble with computers is that you 'play' with them!"),
+			"1F4B84C23A86A221D233F2521BE018D9318639D5B8BBD6374A8A59232D16AD3D", "612AEDE6745CF5DD1CCB89DA21665A8A7CFDF086CF724654A095701EB5C6C4AF",
+			"B552EDD27580141F3B2A5463048CB7CD3E047B97C9F98076C32DBDF85A68718B", "279FA72DD19BFAE05577E06C7C0C1900C371FCD5893F7E1D56A37D30174671F6"},
+		// Hash value not less than the order
+		{"0000000000000000000000000000000000000000000000000000000000000001", hexBytes("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"),
+			"71139AAC71B52F7D5961915AF1B30F94BAF35E39B0043C33D41A57D476A8905C", "19CC9347ED732F3767DB0ADA1223ABD6E4AA4A164499F28B9F373EB957054DC9",
+			"7CB38CC5712E9E11A767615F6080DBC111C9CDD613EB98999FD92A86BAFD4540", "7923CA1F4D03471D2866F776EF8A6D3CAC099B427331AEB245AA9DAFEDDCF115"},
+		{"C1014E82EEE3CD4AECBB43029CD0C4A38F57108887BFD39D4196EFB92A1A81C5", hexBytes("0000000000000000000000000000000000000000000000000000000000000000"),
+			"9167F2A7164F91C427B7603D2FAB4EFC134A6BE239546372439EFEE565974C2D", "8D01A00DBC8ED07121606B22B8744C7B82D1CFF348F869384D2820271DF27A21",
+			"6798CB3F06D6146EAA21ED27534B879FE943960389DCEAA6DFCB0E721DDA3FF3", "4F82C4FBFCC37B34ED05134D30C9878E6ADB33ECCC75765645A157791B7760BD"},
+	};
+	for (unsigned int i = 0; i < ARRAY_LENGTH(cases); i++) {
+		TestCase &tc = cases[i];
+		const Uint256 privateKey(tc.privateKey);
+		const Sha256Hash msgHash(tc.msgHash.data(), tc.msgHash.size());
+		
+		Rfc6979 generator(privateKey, msgHash);
+		assert(generator.nextNonce() == Uint256(tc.nonce0));
+		assert(generator.nextNonce() == Uint256(tc.nonce1));
+		numTestCases++;
+		
+		Uint256 r, s;
+		assert(Ecdsa::signWithRfc6979Nonce(privateKey, msgHash, r, s));
+		assert(r == Uint256(tc.expectedR) && s == Uint256(tc.expectedS));
+		assert(Ecdsa::verify(CurvePoint::privateExponentToPublicPoint(privateKey), msgHash, r, s));
+		numTestCases++;
+	}
+	
+	printf("All %d test cases passed\n", numTestCases);
+	return 0;
+}
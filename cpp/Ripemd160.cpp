@@ -11,34 +11,180 @@
 #include "Ripemd160.hpp"
 #include "Utils.hpp"
 
-#define BLOCK_LEN 64
 
+/*---- Unrolled compression, generic over plain words and SIMD lane vectors ----*/
 
-static uint32_t rotl32(uint32_t x, uint32_t i);
+// Rotates a uint32_t, or every 32-bit element of a vector, left. Requires 1 <= i <= 31.
+#define ROTL_LANES(x, i)  (((x) << (i)) | ((x) >> (32 - (i))))
+
+// The five boolean functions, one per round of the left line and used in reverse order by the right line.
+#define F1(x, y, z)  ((x) ^ (y) ^ (z))
+#define F2(x, y, z)  (((x) & (y)) | (~(x) & (z)))
+#define F3(x, y, z)  (((x) | ~(y)) ^ (z))
+#define F4(x, y, z)  (((x) & (z)) | ((y) & ~(z)))
+#define F5(x, y, z)  ((x) ^ ((y) | ~(z)))
+
+
+// One step of either line. Instead of shifting values between the five variables
+// after each step, the caller rotates which variable plays each role.
+// Vectors are passed by reference, which keeps the calling convention independent of the target attribute.
+template <int S, typename Vec>
+static INLINE_LANES void step(Vec &a, const Vec &f, Vec &c, const Vec &e, const Vec &x, uint32_t k) {
+	a = ROTL_LANES(a + f + x + k, S) + e;
+	c = ROTL_LANES(c, 10);
+}
+
+
+// Compresses one block of 16 little-endian words into the state. Every message index, rotation amount,
+// and constant is a literal at its call site, so nothing is looked up from tables at run time.
+template <typename Vec>
+static INLINE_LANES void compressLanes(Vec state[5], const Vec x[16]) {
+	Vec al = state[0], ar = state[0];
+	Vec bl = state[1], br = state[1];
+	Vec cl = state[2], cr = state[2];
+	Vec dl = state[3], dr = state[3];
+	Vec el = state[4], er = state[4];
+	
+	// Round 1: left line uses F1, right line uses F5
+	step<11>(al, F1(bl, cl, dl), cl, el, x[ 0], UINT32_C(0x00000000));  step< 8>(ar, F5(br, cr, dr), cr, er, x[ 5], UINT32_C(0x50A28BE6));
+	step<14>(el, F1(al, bl, cl), bl, dl, x[ 1], UINT32_C(0x00000000));  step< 9>(er, F5(ar, br, cr), br, dr, x[14], UINT32_C(0x50A28BE6));
+	step<15>(dl, F1(el, al, bl), al, cl, x[ 2], UINT32_C(0x00000000));  step< 9>(dr, F5(er, ar, br), ar, cr, x[ 7], UINT32_C(0x50A28BE6));
+	step<12>(cl, F1(dl, el, al), el, bl, x[ 3], UINT32_C(0x00000000));  step<11>(cr, F5(dr, er, ar), er, br, x[ 0], UINT32_C(0x50A28BE6));
+	step< 5>(bl, F1(cl, dl, el), dl, al, x[ 4], UINT32_C(0x00000000));  step<13>(br, F5(cr, dr, er), dr, ar, x[ 9], UINT32_C(0x50A28BE6));
+	step< 8>(al, F1(bl, cl, dl), cl, el, x[ 5], UINT32_C(0x00000000));  step<15>(ar, F5(br, cr, dr), cr, er, x[ 2], UINT32_C(0x50A28BE6));
+	step< 7>(el, F1(al, bl, cl), bl, dl, x[ 6], UINT32_C(0x00000000));  step<15>(er, F5(ar, br, cr), br, dr, x[11], UINT32_C(0x50A28BE6));
+	step< 9>(dl, F1(el, al, bl), al, cl, x[ 7], UINT32_C(0x00000000));  step< 5>(dr, F5(er, ar, br), ar, cr, x[ 4], UINT32_C(0x50A28BE6));
+	step<11>(cl, F1(dl, el, al), el, bl, x[ 8], UINT32_C(0x00000000));  step< 7>(cr, F5(dr, er, ar), er, br, x[13], UINT32_C(0x50A28BE6));
+	step<13>(bl, F1(cl, dl, el), dl, al, x[ 9], UINT32_C(0x00000000));  step< 7>(br, F5(cr, dr, er), dr, ar, x[ 6], UINT32_C(0x50A28BE6));
+	step<14>(al, F1(bl, cl, dl), cl, el, x[10], UINT32_C(0x00000000));  step< 8>(ar, F5(br, cr, dr), cr, er, x[15], UINT32_C(0x50A28BE6));
+	step<15>(el, F1(al, bl, cl), bl, dl, x[11], UINT32_C(0x00000000));  step<11>(er, F5(ar, br, cr), br, dr, x[ 8], UINT32_C(0x50A28BE6));
+	step< 6>(dl, F1(el, al, bl), al, cl, x[12], UINT32_C(0x00000000));  step<14>(dr, F5(er, ar, br), ar, cr, x[ 1], UINT32_C(0x50A28BE6));
+	step< 7>(cl, F1(dl, el, al), el, bl, x[13], UINT32_C(0x00000000));  step<14>(cr, F5(dr, er, ar), er, br, x[10], UINT32_C(0x50A28BE6));
+	step< 9>(bl, F1(cl, dl, el), dl, al, x[14], UINT32_C(0x00000000));  step<12>(br, F5(cr, dr, er), dr, ar, x[ 3], UINT32_C(0x50A28BE6));
+	step< 8>(al, F1(bl, cl, dl), cl, el, x[15], UINT32_C(0x00000000));  step< 6>(ar, F5(br, cr, dr), cr, er, x[12], UINT32_C(0x50A28BE6));
+	
+	// Round 2: left line uses F2, right line uses F4
+	step< 7>(el, F2(al, bl, cl), bl, dl, x[ 7], UINT32_C(0x5A827999));  step< 9>(er, F4(ar, br, cr), br, dr, x[ 6], UINT32_C(0x5C4DD124));
+	step< 6>(dl, F2(el, al, bl), al, cl, x[ 4], UINT32_C(0x5A827999));  step<13>(dr, F4(er, ar, br), ar, cr, x[11], UINT32_C(0x5C4DD124));
+	step< 8>(cl, F2(dl, el, al), el, bl, x[13], UINT32_C(0x5A827999));  step<15>(cr, F4(dr, er, ar), er, br, x[ 3], UINT32_C(0x5C4DD124));
+	step<13>(bl, F2(cl, dl, el), dl, al, x[ 1], UINT32_C(0x5A827999));  step< 7>(br, F4(cr, dr, er), dr, ar, x[ 7], UINT32_C(0x5C4DD124));
+	step<11>(al, F2(bl, cl, dl), cl, el, x[10], UINT32_C(0x5A827999));  step<12>(ar, F4(br, cr, dr), cr, er, x[ 0], UINT32_C(0x5C4DD124));
+	step< 9>(el, F2(al, bl, cl), bl, dl, x[ 6], UINT32_C(0x5A827999));  step< 8>(er, F4(ar, br, cr), br, dr, x[13], UINT32_C(0x5C4DD124));
+	step< 7>(dl, F2(el, al, bl), al, cl, x[15], UINT32_C(0x5A827999));  step< 9>(dr, F4(er, ar, br), ar, cr, x[ 5], UINT32_C(0x5C4DD124));
+	step<15>(cl, F2(dl, el, al), el, bl, x[ 3], UINT32_C(0x5A827999));  step<11>(cr, F4(dr, er, ar), er, br, x[10], UINT32_C(0x5C4DD124));
+	step< 7>(bl, F2(cl, dl, el), dl, al, x[12], UINT32_C(0x5A827999));  step< 7>(br, F4(cr, dr, er), dr, ar, x[14], UINT32_C(0x5C4DD124));
+	step<12>(al, F2(bl, cl, dl), cl, el, x[ 0], UINT32_C(0x5A827999));  step< 7>(ar, F4(br, cr, dr), cr, er, x[15], UINT32_C(0x5C4DD124));
+	step<15>(el, F2(al, bl, cl), bl, dl, x[ 9], UINT32_C(0x5A827999));  step<12>(er, F4(ar, br, cr), br, dr, x[ 8], UINT32_C(0x5C4DD124));
+	step< 9>(dl, F2(el, al, bl), al, cl, x[ 5], UINT32_C(0x5A827999));  step< 7>(dr, F4(er, ar, br), ar, cr, x[12], UINT32_C(0x5C4DD124));
+	step<11>(cl, F2(dl, el, al), el, bl, x[ 2], UINT32_C(0x5A827999));  step< 6>(cr, F4(dr, er, ar), er, br, x[ 4], UINT32_C(0x5C4DD124));
+	step< 7>(bl, F2(cl, dl, el), dl, al, x[14], UINT32_C(0x5A827999));  step<15>(br, F4(cr, dr, er), dr, ar, x[ 9], UINT32_C(0x5C4DD124));
+	step<13>(al, F2(bl, cl, dl), cl, el, x[11], UINT32_C(0x5A827999));  step<13>(ar, F4(br, cr, dr), cr, er, x[ 1], UINT32_C(0x5C4DD124));
+	step<12>(el, F2(al, bl, cl), bl, dl, x[ 8], UINT32_C(0x5A827999));  step<11>(er, F4(ar, br, cr), br, dr, x[ 2], UINT32_C(0x5C4DD124));
+	
+	// Round 3: left line uses F3, right line uses F3
+	step<11>(dl, F3(el, al, bl), al, cl, x[ 3], UINT32_C(0x6ED9EBA1));  step< 9>(dr, F3(er, ar, br), ar, cr, x[15], UINT32_C(0x6D703EF3));
+	step<13>(cl, F3(dl, el, al), el, bl, x[10], UINT32_C(0x6ED9EBA1));  step< 7>(cr, F3(dr, er, ar), er, br, x[ 5], UINT32_C(0x6D703EF3));
+	step< 6>(bl, F3(cl, dl, el), dl, al, x[14], UINT32_C(0x6ED9EBA1));  step<15>(br, F3(cr, dr, er), dr, ar, x[ 1], UINT32_C(0x6D703EF3));
+	step< 7>(al, F3(bl, cl, dl), cl, el, x[ 4], UINT32_C(0x6ED9EBA1));  step<11>(ar, F3(br, cr, dr), cr, er, x[ 3], UINT32_C(0x6D703EF3));
+	step<14>(el, F3(al, bl, cl), bl, dl, x[ 9], UINT32_C(0x6ED9EBA1));  step< 8>(er, F3(ar, br, cr), br, dr, x[ 7], UINT32_C(0x6D703EF3));
+	step< 9>(dl, F3(el, al, bl), al, cl, x[15], UINT32_C(0x6ED9EBA1));  step< 6>(dr, F3(er, ar, br), ar, cr, x[14], UINT32_C(0x6D703EF3));
+	step<13>(cl, F3(dl, el, al), el, bl, x[ 8], UINT32_C(0x6ED9EBA1));  step< 6>(cr, F3(dr, er, ar), er, br, x[ 6], UINT32_C(0x6D703EF3));
+	step<15>(bl, F3(cl, dl, el), dl, al, x[ 1], UINT32_C(0x6ED9EBA1));  step<14>(br, F3(cr, dr, er), dr, ar, x[ 9], UINT32_C(0x6D703EF3));
+	step<14>(al, F3(bl, cl, dl), cl, el, x[ 2], UINT32_C(0x6ED9EBA1));  step<12>(ar, F3(br, cr, dr), cr, er, x[11], UINT32_C(0x6D703EF3));
+	step< 8>(el, F3(al, bl, cl), bl, dl, x[ 7], UINT32_C(0x6ED9EBA1));  step<13>(er, F3(ar, br, cr), br, dr, x[ 8], UINT32_C(0x6D703EF3));
+	step<13>(dl, F3(el, al, bl), al, cl, x[ 0], UINT32_C(0x6ED9EBA1));  step< 5>(dr, F3(er, ar, br), ar, cr, x[12], UINT32_C(0x6D703EF3));
+	step< 6>(cl, F3(dl, el, al), el, bl, x[ 6], UINT32_C(0x6ED9EBA1));  step<14>(cr, F3(dr, er, ar), er, br, x[ 2], UINT32_C(0x6D703EF3));
+	step< 5>(bl, F3(cl, dl, el), dl, al, x[13], UINT32_C(0x6ED9EBA1));  step<13>(br, F3(cr, dr, er), dr, ar, x[10], UINT32_C(0x6D703EF3));
+	step<12>(al, F3(bl, cl, dl), cl, el, x[11], UINT32_C(0x6ED9EBA1));  step<13>(ar, F3(br, cr, dr), cr, er, x[ 0], UINT32_C(0x6D703EF3));
+	step< 7>(el, F3(al, bl, cl), bl, dl, x[ 5], UINT32_C(0x6ED9EBA1));  step< 7>(er, F3(ar, br, cr), br, dr, x[ 4], UINT32_C(0x6D703EF3));
+	step< 5>(dl, F3(el, al, bl), al, cl, x[12], UINT32_C(0x6ED9EBA1));  step< 5>(dr, F3(er, ar, br), ar, cr, x[13], UINT32_C(0x6D703EF3));
+	
+	// Round 4: left line uses F4, right line uses F2
+	step<11>(cl, F4(dl, el, al), el, bl, x[ 1], UINT32_C(0x8F1BBCDC));  step<15>(cr, F2(dr, er, ar), er, br, x[ 8], UINT32_C(0x7A6D76E9));
+	step<12>(bl, F4(cl, dl, el), dl, al, x[ 9], UINT32_C(0x8F1BBCDC));  step< 5>(br, F2(cr, dr, er), dr, ar, x[ 6], UINT32_C(0x7A6D76E9));
+	step<14>(al, F4(bl, cl, dl), cl, el, x[11], UINT32_C(0x8F1BBCDC));  step< 8>(ar, F2(br, cr, dr), cr, er, x[ 4], UINT32_C(0x7A6D76E9));
+	step<15>(el, F4(al, bl, cl), bl, dl, x[10], UINT32_C(0x8F1BBCDC));  step<11>(er, F2(ar, br, cr), br, dr, x[ 1], UINT32_C(0x7A6D76E9));
+	step<14>(dl, F4(el, al, bl), al, cl, x[ 0], UINT32_C(0x8F1BBCDC));  step<14>(dr, F2(er, ar, br), ar, cr, x[ 3], UINT32_C(0x7A6D76E9));
+	step<15>(cl, F4(dl, el, al), el, bl, x[ 8], UINT32_C(0x8F1BBCDC));  step<14>(cr, F2(dr, er, ar), er, br, x[11], UINT32_C(0x7A6D76E9));
+	step< 9>(bl, F4(cl, dl, el), dl, al, x[12], UINT32_C(0x8F1BBCDC));  step< 6>(br, F2(cr, dr, er), dr, ar, x[15], UINT32_C(0x7A6D76E9));
+	step< 8>(al, F4(bl, cl, dl), cl, el, x[ 4], UINT32_C(0x8F1BBCDC));  step<14>(ar, F2(br, cr, dr), cr, er, x[ 0], UINT32_C(0x7A6D76E9));
+	step< 9>(el, F4(al, bl, cl), bl, dl, x[13], UINT32_C(0x8F1BBCDC));  step< 6>(er, F2(ar, br, cr), br, dr, x[ 5], UINT32_C(0x7A6D76E9));
+	step<14>(dl, F4(el, al, bl), al, cl, x[ 3], UINT32_C(0x8F1BBCDC));  step< 9>(dr, F2(er, ar, br), ar, cr, x[12], UINT32_C(0x7A6D76E9));
+	step< 5>(cl, F4(dl, el, al), el, bl, x[ 7], UINT32_C(0x8F1BBCDC));  step<12>(cr, F2(dr, er, ar), er, br, x[ 2], UINT32_C(0x7A6D76E9));
+	step< 6>(bl, F4(cl, dl, el), dl, al, x[15], UINT32_C(0x8F1BBCDC));  step< 9>(br, F2(cr, dr, er), dr, ar, x[13], UINT32_C(0x7A6D76E9));
+	step< 8>(al, F4(bl, cl, dl), cl, el, x[14], UINT32_C(0x8F1BBCDC));  step<12>(ar, F2(br, cr, dr), cr, er, x[ 9], UINT32_C(0x7A6D76E9));
+	step< 6>(el, F4(al, bl, cl), bl, dl, x[ 5], UINT32_C(0x8F1BBCDC));  step< 5>(er, F2(ar, br, cr), br, dr, x[ 7], UINT32_C(0x7A6D76E9));
+	step< 5>(dl, F4(el, al, bl), al, cl, x[ 6], UINT32_C(0x8F1BBCDC));  step<15>(dr, F2(er, ar, br), ar, cr, x[10], UINT32_C(0x7A6D76E9));
+	step<12>(cl, F4(dl, el, al), el, bl, x[ 2], UINT32_C(0x8F1BBCDC));  step< 8>(cr, F2(dr, er, ar), er, br, x[14], UINT32_C(0x7A6D76E9));
+	
+	// Round 5: left line uses F5, right line uses F1
+	step< 9>(bl, F5(cl, dl, el), dl, al, x[ 4], UINT32_C(0xA953FD4E));  step< 8>(br, F1(cr, dr, er), dr, ar, x[12], UINT32_C(0x00000000));
+	step<15>(al, F5(bl, cl, dl), cl, el, x[ 0], UINT32_C(0xA953FD4E));  step< 5>(ar, F1(br, cr, dr), cr, er, x[15], UINT32_C(0x00000000));
+	step< 5>(el, F5(al, bl, cl), bl, dl, x[ 5], UINT32_C(0xA953FD4E));  step<12>(er, F1(ar, br, cr), br, dr, x[10], UINT32_C(0x00000000));
+	step<11>(dl, F5(el, al, bl), al, cl, x[ 9], UINT32_C(0xA953FD4E));  step< 9>(dr, F1(er, ar, br), ar, cr, x[ 4], UINT32_C(0x00000000));
+	step< 6>(cl, F5(dl, el, al), el, bl, x[ 7], UINT32_C(0xA953FD4E));  step<12>(cr, F1(dr, er, ar), er, br, x[ 1], UINT32_C(0x00000000));
+	step< 8>(bl, F5(cl, dl, el), dl, al, x[12], UINT32_C(0xA953FD4E));  step< 5>(br, F1(cr, dr, er), dr, ar, x[ 5], UINT32_C(0x00000000));
+	step<13>(al, F5(bl, cl, dl), cl, el, x[ 2], UINT32_C(0xA953FD4E));  step<14>(ar, F1(br, cr, dr), cr, er, x[ 8], UINT32_C(0x00000000));
+	step<12>(el, F5(al, bl, cl), bl, dl, x[10], UINT32_C(0xA953FD4E));  step< 6>(er, F1(ar, br, cr), br, dr, x[ 7], UINT32_C(0x00000000));
+	step< 5>(dl, F5(el, al, bl), al, cl, x[14], UINT32_C(0xA953FD4E));  step< 8>(dr, F1(er, ar, br), ar, cr, x[ 6], UINT32_C(0x00000000));
+	step<12>(cl, F5(dl, el, al), el, bl, x[ 1], UINT32_C(0xA953FD4E));  step<13>(cr, F1(dr, er, ar), er, br, x[ 2], UINT32_C(0x00000000));
+	step<13>(bl, F5(cl, dl, el), dl, al, x[ 3], UINT32_C(0xA953FD4E));  step< 6>(br, F1(cr, dr, er), dr, ar, x[13], UINT32_C(0x00000000));
+	step<14>(al, F5(bl, cl, dl), cl, el, x[ 8], UINT32_C(0xA953FD4E));  step< 5>(ar, F1(br, cr, dr), cr, er, x[14], UINT32_C(0x00000000));
+	step<11>(el, F5(al, bl, cl), bl, dl, x[11], UINT32_C(0xA953FD4E));  step<15>(er, F1(ar, br, cr), br, dr, x[ 0], UINT32_C(0x00000000));
+	step< 8>(dl, F5(el, al, bl), al, cl, x[ 6], UINT32_C(0xA953FD4E));  step<13>(dr, F1(er, ar, br), ar, cr, x[ 3], UINT32_C(0x00000000));
+	step< 5>(cl, F5(dl, el, al), el, bl, x[15], UINT32_C(0xA953FD4E));  step<11>(cr, F1(dr, er, ar), er, br, x[ 9], UINT32_C(0x00000000));
+	step< 6>(bl, F5(cl, dl, el), dl, al, x[13], UINT32_C(0xA953FD4E));  step<11>(br, F1(cr, dr, er), dr, ar, x[11], UINT32_C(0x00000000));
+	
+	Vec temp = state[1] + cl + dr;
+	state[1] = state[2] + dl + er;
+	state[2] = state[3] + el + ar;
+	state[3] = state[4] + al + br;
+	state[4] = state[0] + bl + cr;
+	state[0] = temp;
+}
+
+#undef ROTL_LANES
+#undef F1
+#undef F2
+#undef F3
+#undef F4
+#undef F5
+
+
+static uint32_t loadLittleEndian(const uint8_t b[4]) {
+	return static_cast<uint32_t>(b[0]) <<  0
+	     | static_cast<uint32_t>(b[1]) <<  8
+	     | static_cast<uint32_t>(b[2]) << 16
+	     | static_cast<uint32_t>(b[3]) << 24;
+}
+
+
+/*---- Ripemd160 class ----*/
 
 
 void Ripemd160::getHash(const uint8_t *msg, size_t len, uint8_t hashResult[RIPEMD160_HASH_LEN]) {
 	// Compress whole message blocks
 	assert((msg != nullptr || len == 0) && hashResult != nullptr);
-	uint32_t state[5] = {UINT32_C(0x67452301), UINT32_C(0xEFCDAB89), UINT32_C(0x98BADCFE), UINT32_C(0x10325476), UINT32_C(0xC3D2E1F0)};
-	size_t off = len & ~static_cast<size_t>(BLOCK_LEN - 1);
+	uint32_t state[5];
+	memcpy(state, INITIAL_STATE, sizeof(state));
+	size_t off = len & ~static_cast<size_t>(RIPEMD160_BLOCK_LEN - 1);
 	compress(state, msg, off);
 	
 	// Final blocks, padding, and length
-	uint8_t block[BLOCK_LEN] = {};
+	uint8_t block[RIPEMD160_BLOCK_LEN] = {};
 	Utils::copyBytes(block, &msg[off], len - off);
-	off = len & (BLOCK_LEN - 1);
+	off = len & (RIPEMD160_BLOCK_LEN - 1);
 	block[off] = 0x80;
 	off++;
-	if (off + 8 > BLOCK_LEN) {
-		compress(state, block, BLOCK_LEN);
-		memset(block, 0, BLOCK_LEN);
+	if (off + 8 > RIPEMD160_BLOCK_LEN) {
+		compress(state, block, RIPEMD160_BLOCK_LEN);
+		memset(block, 0, RIPEMD160_BLOCK_LEN);
 	}
-	block[BLOCK_LEN - 8] = static_cast<uint8_t>((len & 0x1FU) << 3);
+	block[RIPEMD160_BLOCK_LEN - 8] = static_cast<uint8_t>((len & 0x1FU) << 3);
 	len >>= 5;
 	for (int i = 1; i < 8; i++, len >>= 8)
-		block[BLOCK_LEN - 8 + i] = static_cast<uint8_t>(len);
-	compress(state, block, BLOCK_LEN);
+		block[RIPEMD160_BLOCK_LEN - 8 + i] = static_cast<uint8_t>(len);
+	compress(state, block, RIPEMD160_BLOCK_LEN);
 	
 	// Uint32 array to bytes in little endian
 	for (int i = 0; i < RIPEMD160_HASH_LEN; i++)
@@ -47,99 +193,176 @@ void Ripemd160::getHash(const uint8_t *msg, size_t len, uint8_t hashResult[RIPEM
 
 
 void Ripemd160::compress(uint32_t state[5], const uint8_t *blocks, size_t len) {
-	assert(len % BLOCK_LEN == 0);
-	uint32_t schedule[16];
-	for (size_t i = 0; i < len; ) {
-		
-		// Message schedule
-		for (int j = 0; j < 16; j++, i += 4) {
-			schedule[j] = static_cast<uint32_t>(blocks[i + 0]) <<  0
-			            | static_cast<uint32_t>(blocks[i + 1]) <<  8
-			            | static_cast<uint32_t>(blocks[i + 2]) << 16
-			            | static_cast<uint32_t>(blocks[i + 3]) << 24;
+	assert(state != nullptr && (blocks != nullptr || len == 0));
+	assert(len % RIPEMD160_BLOCK_LEN == 0);
+	for (size_t i = 0; i < len; i += RIPEMD160_BLOCK_LEN) {
+		uint32_t schedule[16];
+		for (int j = 0; j < 16; j++)
+			schedule[j] = loadLittleEndian(&blocks[i + j * 4]);
+		compressWords(state, schedule);
+	}
+}
+
+
+void Ripemd160::compressMulti(uint32_t *const states[], const uint8_t *const blocks[], size_t len) {
+	assert((states != nullptr && blocks != nullptr) || len == 0);
+	// Decode a chunk of blocks at a time, which costs little next to compressing them
+	const size_t CHUNK = 32;
+	uint32_t words[CHUNK][16];
+	const uint32_t *wordPtrs[CHUNK];
+	for (size_t i = 0; i < len; i += CHUNK) {
+		size_t n = len - i < CHUNK ? len - i : CHUNK;
+		for (size_t j = 0; j < n; j++) {
+			for (int k = 0; k < 16; k++)
+				words[j][k] = loadLittleEndian(&blocks[i + j][k * 4]);
+			wordPtrs[j] = words[j];
+		}
+		compressWordsMulti(&states[i], wordPtrs, n);
+	}
+}
+
+
+void Ripemd160::compressWords(uint32_t state[5], const uint32_t words[16]) {
+	assert(state != nullptr && words != nullptr);
+	compressLanes<uint32_t>(state, words);
+}
+
+
+void Ripemd160::compressWordsMulti(uint32_t *const states[], const uint32_t *const words[], size_t len) {
+	assert((states != nullptr && words != nullptr) || len == 0);
+	static const CompressWordsMultiFunc func = selectCompressWordsMulti();  // Thread-safe initialization since C++11
+	func(states, words, len);
+}
+
+
+Ripemd160::CompressWordsMultiFunc Ripemd160::selectCompressWordsMulti() {
+#ifdef USE_X86_INTRINSICS
+	const Utils::CpuFeatures &cpu = Utils::getCpuFeatures();
+	if (cpu.avx2)
+		return compressWordsMultiAvx2;
+	if (cpu.sse41)
+		return compressWordsMultiSse41;
+#endif
+	return compressWordsMultiSerial;
+}
+
+
+void Ripemd160::compressWordsMultiSerial(uint32_t *const states[], const uint32_t *const words[], size_t len) {
+	for (size_t i = 0; i < len; i++)
+		compressWords(states[i], words[i]);
+}
+
+
+#ifdef USE_X86_INTRINSICS
+
+// Compresses one block into each of the given states, LANES at a time. A final partial group is padded with dummy lanes.
+template <typename Vec, int LANES>
+static INLINE_LANES void compressMultiLanes(
+		uint32_t *const states[], const uint32_t *const words[], size_t len) {
+	uint32_t dummyState[5] = {};
+	const uint32_t dummyWords[16] = {};
+	for (size_t i = 0; i < len; i += LANES) {
+		uint32_t *laneStates[LANES];
+		const uint32_t *laneWords[LANES];
+		for (int k = 0; k < LANES; k++) {
+			bool active = i + k < len;
+			laneStates[k] = active ? states[i + k] : dummyState;
+			laneWords[k] = active ? words[i + k] : dummyWords;
 		}
 		
-		// The 80 rounds
-		uint32_t al = state[0], ar = state[0];
-		uint32_t bl = state[1], br = state[1];
-		uint32_t cl = state[2], cr = state[2];
-		uint32_t dl = state[3], dr = state[3];
-		uint32_t el = state[4], er = state[4];
-		for (unsigned int j = 0; j < 80; j++) {
-			uint32_t temp;
-			temp = 0U + rotl32(0U + al + f(j, bl, cl, dl) + schedule[RL[j]] + KL[j >> 4], SL[j]) + el;
-			al = el;
-			el = dl;
-			dl = rotl32(cl, 10);
-			cl = bl;
-			bl = temp;
-			temp = 0U + rotl32(0U + ar + f(79 - j, br, cr, dr) + schedule[RR[j]] + KR[j >> 4], SR[j]) + er;
-			ar = er;
-			er = dr;
-			dr = rotl32(cr, 10);
-			cr = br;
-			br = temp;
+		Vec state[5];
+		Vec schedule[16];
+		for (int j = 0; j < 5; j++) {
+			for (int k = 0; k < LANES; k++)
+				state[j][k] = laneStates[k][j];
+		}
+		for (int j = 0; j < 16; j++) {
+			for (int k = 0; k < LANES; k++)
+				schedule[j][k] = laneWords[k][j];
+		}
+		compressLanes<Vec>(state, schedule);
+		for (int j = 0; j < 5; j++) {
+			for (int k = 0; k < LANES; k++)
+				laneStates[k][j] = state[j][k];
 		}
-		uint32_t temp = 0U + state[1] + cl + dr;
-		state[1] = 0U + state[2] + dl + er;
-		state[2] = 0U + state[3] + el + ar;
-		state[3] = 0U + state[4] + al + br;
-		state[4] = 0U + state[0] + bl + cr;
-		state[0] = temp;
 	}
 }
 
 
-uint32_t Ripemd160::f(unsigned int i, uint32_t x, uint32_t y, uint32_t z) {
-	switch (i >> 4) {
-		case 0:  return x ^ y ^ z;
-		case 1:  return (x & y) | (~x & z);
-		case 2:  return (x | ~y) ^ z;
-		case 3:  return (x & z) | (y & ~z);
-		case 4:  return x ^ (y | ~z);
-		default:  assert(false);  return 0;  // Dummy value to please the compiler
-	}
+typedef uint32_t Uint32x4 __attribute__((vector_size(16)));
+typedef uint32_t Uint32x8 __attribute__((vector_size(32)));
+
+
+__attribute__((target("sse4.1")))
+void Ripemd160::compressWordsMultiSse41(uint32_t *const states[], const uint32_t *const words[], size_t len) {
+	compressMultiLanes<Uint32x4, 4>(states, words, len);
+}
+
+
+__attribute__((target("avx2")))
+void Ripemd160::compressWordsMultiAvx2(uint32_t *const states[], const uint32_t *const words[], size_t len) {
+	compressMultiLanes<Uint32x8, 8>(states, words, len);
 }
 
+#endif
 
-Ripemd160::Ripemd160() {}
 
+Ripemd160::Ripemd160() :
+		length(0),
+		buffer(),
+		bufferLen(0) {
+	memcpy(state, INITIAL_STATE, sizeof(state));
+}
 
-#undef BLOCK_LEN
 
+void Ripemd160::append(const uint8_t *bytes, size_t len) {
+	assert(bytes != nullptr || len == 0);
+	length += len;
+	
+	// Top up a partially filled buffer
+	if (bufferLen > 0) {
+		size_t n = RIPEMD160_BLOCK_LEN - static_cast<size_t>(bufferLen);
+		if (n > len)
+			n = len;
+		Utils::copyBytes(&buffer[bufferLen], bytes, n);
+		bufferLen += static_cast<int>(n);
+		bytes += n;
+		len -= n;
+		if (bufferLen < RIPEMD160_BLOCK_LEN)
+			return;
+		compress(state, buffer, RIPEMD160_BLOCK_LEN);
+		bufferLen = 0;
+	}
+	
+	// Compress whole blocks straight from the input, and buffer the rest
+	size_t wholeLen = len & ~static_cast<size_t>(RIPEMD160_BLOCK_LEN - 1);
+	compress(state, bytes, wholeLen);
+	Utils::copyBytes(buffer, bytes + wholeLen, len - wholeLen);
+	bufferLen = static_cast<int>(len - wholeLen);
+}
 
-// Static initializers
-const uint32_t Ripemd160::KL[5] = {
-	UINT32_C(0x00000000), UINT32_C(0x5A827999), UINT32_C(0x6ED9EBA1), UINT32_C(0x8F1BBCDC), UINT32_C(0xA953FD4E)};
-const uint32_t Ripemd160::KR[5] = {
-	UINT32_C(0x50A28BE6), UINT32_C(0x5C4DD124), UINT32_C(0x6D703EF3), UINT32_C(0x7A6D76E9), UINT32_C(0x00000000)};
-const unsigned int Ripemd160::RL[80] = {
-	 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15,
-	 7,  4, 13,  1, 10,  6, 15,  3, 12,  0,  9,  5,  2, 14, 11,  8,
-	 3, 10, 14,  4,  9, 15,  8,  1,  2,  7,  0,  6, 13, 11,  5, 12,
-	 1,  9, 11, 10,  0,  8, 12,  4, 13,  3,  7, 15, 14,  5,  6,  2,
-	 4,  0,  5,  9,  7, 12,  2, 10, 14,  1,  3,  8, 11,  6, 15, 13};
-const unsigned int Ripemd160::RR[80] = {
-	 5, 14,  7,  0,  9,  2, 11,  4, 13,  6, 15,  8,  1, 10,  3, 12,
-	 6, 11,  3,  7,  0, 13,  5, 10, 14, 15,  8, 12,  4,  9,  1,  2,
-	15,  5,  1,  3,  7, 14,  6,  9, 11,  8, 12,  2, 10,  0,  4, 13,
-	 8,  6,  4,  1,  3, 11, 15,  0,  5, 12,  2, 13,  9,  7, 10, 14,
-	12, 15, 10,  4,  1,  5,  8,  7,  6,  2, 13, 14,  0,  3,  9, 11};
-const unsigned int Ripemd160::SL[80] = {
-	11, 14, 15, 12,  5,  8,  7,  9, 11, 13, 14, 15,  6,  7,  9,  8,
-	 7,  6,  8, 13, 11,  9,  7, 15,  7, 12, 15,  9, 11,  7, 13, 12,
-	11, 13,  6,  7, 14,  9, 13, 15, 14,  8, 13,  6,  5, 12,  7,  5,
-	11, 12, 14, 15, 14, 15,  9,  8,  9, 14,  5,  6,  8,  6,  5, 12,
-	 9, 15,  5, 11,  6,  8, 13, 12,  5, 12, 13, 14, 11,  8,  5,  6};
-const unsigned int Ripemd160::SR[80] = {
-	 8,  9,  9, 11, 13, 15, 15,  5,  7,  7,  8, 11, 14, 14, 12,  6,
-	 9, 13, 15,  7, 12,  8,  9, 11,  7,  7, 12,  7,  6, 15, 13, 11,
-	 9,  7, 15, 11,  8,  6,  6, 14, 12, 13,  5, 14, 13, 13,  7,  5,
-	15,  5,  8, 11, 14, 14,  6, 14,  6,  9, 12,  9, 12,  5, 15,  8,
-	 8,  5, 12,  9, 12,  5, 14,  6,  8, 13,  6,  5, 15, 13, 11, 11};
-
-
-// Requires 1 <= i <= 31
-static uint32_t rotl32(uint32_t x, uint32_t i) {
-	return ((0U + x) << i) | (x >> (32 - i));
+
+void Ripemd160::getHash(uint8_t hashResult[RIPEMD160_HASH_LEN]) const {
+	assert(hashResult != nullptr);
+	
+	// Pad the buffered bytes into one or two final blocks, compressed into a copy of the state
+	uint32_t tempState[5];
+	memcpy(tempState, state, sizeof(tempState));
+	uint8_t blocks[RIPEMD160_BLOCK_LEN * 2] = {};
+	memcpy(blocks, buffer, static_cast<size_t>(bufferLen));
+	blocks[bufferLen] = 0x80;
+	size_t blocksLen = bufferLen + 9 <= RIPEMD160_BLOCK_LEN ? RIPEMD160_BLOCK_LEN : RIPEMD160_BLOCK_LEN * 2;
+	uint64_t bitLength = length << 3;
+	for (int i = 8; i >= 1; i--, bitLength >>= 8)  // Little endian
+		blocks[blocksLen - i] = static_cast<uint8_t>(bitLength);
+	compress(tempState, blocks, blocksLen);
+	
+	// Uint32 array to bytes in little endian
+	for (int i = 0; i < RIPEMD160_HASH_LEN; i++)
+		hashResult[i] = static_cast<uint8_t>(tempState[i >> 2] >> ((i & 3) << 3));
 }
+
+
+// Static initializers
+const uint32_t Ripemd160::INITIAL_STATE[5] = {
+	UINT32_C(0x67452301), UINT32_C(0xEFCDAB89), UINT32_C(0x98BADCFE), UINT32_C(0x10325476), UINT32_C(0xC3D2E1F0)};
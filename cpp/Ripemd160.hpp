@@ -14,9 +14,10 @@
 
 /* 
  * Computes the RIPEMD-160 hash of a sequence of bytes. The hash value is 20 bytes long.
- * Provides just one static method.
+ * Provides a static method, and an instantiable stateful hasher.
  */
 #define RIPEMD160_HASH_LEN 20
+#define RIPEMD160_BLOCK_LEN 64
 class Ripemd160 final {
 	
 	/*---- Static functions ----*/
@@ -25,23 +26,71 @@ public:
 	static void getHash(const uint8_t *msg, size_t len, uint8_t hashResult[RIPEMD160_HASH_LEN]);
 	
 	
+	// Compresses whole blocks into the given state, using a fully unrolled step sequence.
+	static void compress(uint32_t state[5], const uint8_t *blocks, size_t len);
+	
+	
+	// Compresses exactly one block into each state, such that the effect is equivalent to calling
+	// compress(states[i], blocks[i], RIPEMD160_BLOCK_LEN) for each i. Processes 8 (AVX2) or 4 (SSE4.1)
+	// states in parallel SIMD lanes if the CPU supports them, or else calls compress() in a loop.
+	static void compressMulti(uint32_t *const states[], const uint8_t *const blocks[], size_t len);
+	
+	
+	// Compresses one block that is already decoded into 16 message words (each word is 4 block bytes
+	// in little endian). This suits callers that build the block from other hash state words.
+	static void compressWords(uint32_t state[5], const uint32_t words[16]);
+	
+	
+	// Like compressMulti(), but each block is given as 16 decoded message words like in compressWords().
+	static void compressWordsMulti(uint32_t *const states[], const uint32_t *const words[], size_t len);
+	
+	
 private:
+	typedef void (*CompressWordsMultiFunc)(uint32_t *const states[], const uint32_t *const words[], size_t len);
 	
-	static void compress(uint32_t state[5], const uint8_t *blocks, size_t len);
+	static CompressWordsMultiFunc selectCompressWordsMulti();
+	
+	static void compressWordsMultiSerial(uint32_t *const states[], const uint32_t *const words[], size_t len);
+	
+	// Only defined if USE_X86_INTRINSICS is defined.
+	static void compressWordsMultiSse41(uint32_t *const states[], const uint32_t *const words[], size_t len);
+	
+	// Only defined if USE_X86_INTRINSICS is defined.
+	static void compressWordsMultiAvx2(uint32_t *const states[], const uint32_t *const words[], size_t len);
 	
-	static uint32_t f(unsigned int i, uint32_t x, uint32_t y, uint32_t z);
+	// Lets the test suite call every kernel that the CPU supports, not just the selected one.
+	friend class Ripemd160Test;
 	
-	Ripemd160();  // Not instantiable
+	
+	
+	/*---- Stateful hasher fields and methods ----*/
+	
+private:
+	uint32_t state[5];
+	uint64_t length;
+	uint8_t buffer[RIPEMD160_BLOCK_LEN];
+	int bufferLen;
+	
+	
+public:
+	// Constructs a new RIPEMD-160 hasher with an initially blank message. Hashers are copyable,
+	// so a copy taken after appending a common prefix can be resumed any number of times.
+	Ripemd160();
+	
+	
+	// Appends message bytes to this ongoing hasher. Whole blocks are compressed directly from the given array.
+	void append(const uint8_t *bytes, size_t len);
+	
+	
+	// Writes the RIPEMD-160 hash of all the bytes seen. Doesn't change this hasher, so
+	// more bytes can be appended and getHash() can be called again afterward.
+	void getHash(uint8_t hashResult[RIPEMD160_HASH_LEN]) const;
 	
 	
 	
 	/*---- Class constants ----*/
 	
-	static const uint32_t KL[5];       // Round constants for left line
-	static const uint32_t KR[5];       // Round constants for right line
-	static const unsigned int RL[80];  // Message schedule for left line
-	static const unsigned int RR[80];  // Message schedule for right line
-	static const unsigned int SL[80];  // Left-rotation for left line
-	static const unsigned int SR[80];  // Left-rotation for right line
+public:
+	static const uint32_t INITIAL_STATE[5];
 	
 };
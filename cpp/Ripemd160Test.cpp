@@ -9,10 +9,13 @@
  */
 
 #include "TestHelper.hpp"
+#include <algorithm>
 #include <cstdio>
 #include <cstdint>
 #include <cstring>
+#include <vector>
 #include "Ripemd160.hpp"
+#include "Utils.hpp"
 
 
 /*---- Structures ----*/
@@ -24,6 +27,31 @@ struct TestCase {
 };
 
 
+// Has access to the private kernels of Ripemd160, because dispatch selects only one of them for the running CPU.
+class Ripemd160Test final {
+	
+public:
+	
+	typedef Ripemd160::CompressWordsMultiFunc CompressWordsMultiFunc;
+	
+	
+	// Returns the portable kernel and every SIMD kernel that the running CPU supports.
+	static std::vector<CompressWordsMultiFunc> getCompressWordsMultiKernels() {
+		std::vector<CompressWordsMultiFunc> result;
+		result.push_back(Ripemd160::compressWordsMultiSerial);
+#ifdef USE_X86_INTRINSICS
+		const Utils::CpuFeatures &cpu = Utils::getCpuFeatures();
+		if (cpu.sse41)
+			result.push_back(Ripemd160::compressWordsMultiSse41);
+		if (cpu.avx2)
+			result.push_back(Ripemd160::compressWordsMultiAvx2);
+#endif
+		return result;
+	}
+	
+};
+
+
 /*---- Test suite ----*/
 
 int main(int argc, char **argv) {
@@ -201,6 +229,72 @@ int main(int argc, char **argv) {
 		Ripemd160::getHash(tc.message.data(), tc.message.size(), actualHash);
 		assert((memcmp(actualHash, expectHash.data(), RIPEMD160_HASH_LEN) == 0) == tc.matches);
 		numTestCases++;
+		
+		// The stateful hasher must agree with the static function for every piece size
+		for (size_t pieceLen = 1; pieceLen <= tc.message.size(); pieceLen *= 3) {
+			Ripemd160 hasher;
+			for (size_t off = 0; off < tc.message.size(); off += pieceLen) {
+				size_t n = std::min(pieceLen, tc.message.size() - off);
+				hasher.append(&tc.message[off], n);
+			}
+			uint8_t pieceHash[RIPEMD160_HASH_LEN] = {};
+			hasher.getHash(pieceHash);
+			assert(memcmp(pieceHash, actualHash, RIPEMD160_HASH_LEN) == 0);
+			
+			// Finishing is non-destructive, and copies are independent snapshots
+			Ripemd160 copy(hasher);
+			copy.append(tc.message.data(), tc.message.size());
+			hasher.getHash(pieceHash);
+			assert(memcmp(pieceHash, actualHash, RIPEMD160_HASH_LEN) == 0);
+			numTestCases++;
+		}
+	}
+	
+	// Multi-buffer compression versus single compression, for each number of lanes,
+	// through dispatch and through every words kernel that the CPU supports
+	const std::vector<Ripemd160Test::CompressWordsMultiFunc> wordsKernels(Ripemd160Test::getCompressWordsMultiKernels());
+	for (size_t count = 0; count <= 20; count++) {
+		uint8_t blocks[20][RIPEMD160_BLOCK_LEN];
+		uint32_t states[20][5];
+		uint32_t expectStates[20][5];
+		uint32_t *statePtrs[20];
+		const uint8_t *blockPtrs[20];
+		for (size_t i = 0; i < count; i++) {
+			for (int j = 0; j < RIPEMD160_BLOCK_LEN; j++)
+				blocks[i][j] = static_cast<uint8_t>(i * 31 + j * 7 + count);
+			for (int j = 0; j < 5; j++)
+				states[i][j] = expectStates[i][j] = static_cast<uint32_t>(0x9E3779B9U * (i * 5 + j + 1));
+			statePtrs[i] = states[i];
+			blockPtrs[i] = blocks[i];
+			Ripemd160::compress(expectStates[i], blocks[i], RIPEMD160_BLOCK_LEN);
+		}
+		Ripemd160::compressMulti(statePtrs, blockPtrs, count);
+		for (size_t i = 0; i < count; i++)
+			assert(memcmp(states[i], expectStates[i], sizeof(states[i])) == 0);
+		numTestCases++;
+		
+		// Every kernel that the CPU supports, on the blocks decoded as little-endian words
+		uint32_t words[20][16];
+		const uint32_t *wordPtrs[20];
+		for (size_t i = 0; i < count; i++) {
+			for (int j = 0; j < 16; j++) {
+				words[i][j] = static_cast<uint32_t>(blocks[i][j * 4 + 0]) <<  0
+				            | static_cast<uint32_t>(blocks[i][j * 4 + 1]) <<  8
+				            | static_cast<uint32_t>(blocks[i][j * 4 + 2]) << 16
+				            | static_cast<uint32_t>(blocks[i][j * 4 + 3]) << 24;
+			}
+			wordPtrs[i] = words[i];
+		}
+		for (size_t k = 0; k < wordsKernels.size(); k++) {
+			for (size_t i = 0; i < count; i++) {
+				for (int j = 0; j < 5; j++)
+					states[i][j] = static_cast<uint32_t>(0x9E3779B9U * (i * 5 + j + 1));
+			}
+			wordsKernels[k](statePtrs, wordPtrs, count);
+			for (size_t i = 0; i < count; i++)
+				assert(memcmp(states[i], expectStates[i], sizeof(states[i])) == 0);
+			numTestCases++;
+		}
 	}
 	printf("All %d test cases passed\n", numTestCases);
 	return 0;
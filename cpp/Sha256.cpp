@@ -11,10 +11,40 @@
 #include "Sha256.hpp"
 #include "Utils.hpp"
 
+#ifdef USE_X86_INTRINSICS
+	#include <immintrin.h>
+#endif
+
 
 static uint32_t rotr32(uint32_t x, uint32_t i);
 
 
+HmacSha256Key::HmacSha256Key(const uint8_t *key, size_t keyLen) {
+	assert(key != nullptr || keyLen == 0);
+	
+	// Preprocess key
+	uint8_t tempKey[SHA256_BLOCK_LEN] = {};
+	if (keyLen <= SHA256_BLOCK_LEN)
+		Utils::copyBytes(tempKey, key, keyLen);
+	else {
+		const Sha256Hash keyHash(Sha256::getHash(key, keyLen));
+		memcpy(tempKey, keyHash.value, SHA256_HASH_LEN);
+	}
+	
+	// Compress inner key block
+	for (int i = 0; i < SHA256_BLOCK_LEN; i++)
+		tempKey[i] ^= 0x36;
+	memcpy(innerState, Sha256::INITIAL_STATE, sizeof(innerState));
+	Sha256::compress(innerState, tempKey, SHA256_BLOCK_LEN);
+	
+	// Compress outer key block
+	for (int i = 0; i < SHA256_BLOCK_LEN; i++)
+		tempKey[i] ^= 0x36 ^ 0x5C;
+	memcpy(outerState, Sha256::INITIAL_STATE, sizeof(outerState));
+	Sha256::compress(outerState, tempKey, SHA256_BLOCK_LEN);
+}
+
+
 Sha256Hash Sha256::getHash(const uint8_t *msg, size_t len) {
 	assert(msg != nullptr || len == 0);
 	return getHash(msg, len, INITIAL_STATE, 0);
@@ -23,37 +53,65 @@ Sha256Hash Sha256::getHash(const uint8_t *msg, size_t len) {
 
 Sha256Hash Sha256::getDoubleHash(const uint8_t *msg, size_t len) {
 	assert(msg != nullptr || len == 0);
+	if (len == SHA256_BLOCK_LEN)
+		return getDoubleHash64(msg);
 	const Sha256Hash innerHash(getHash(msg, len));
 	return getHash(innerHash.value, SHA256_HASH_LEN);
 }
 
 
+Sha256Hash Sha256::getDoubleHash64(const uint8_t msg[SHA256_BLOCK_LEN]) {
+	assert(msg != nullptr);
+	Sha256Hash result;
+	getDoubleHash64Serial(msg, 1, &result);
+	return result;
+}
+
+
+void Sha256::getDoubleHash64Multi(const uint8_t msgs[], size_t len, Sha256Hash out[]) {
+	assert((msgs != nullptr && out != nullptr) || len == 0);
+	static const DoubleHash64Func func = selectDoubleHash64();  // Thread-safe initialization since C++11
+	func(msgs, len, out);
+}
+
+
 Sha256Hash Sha256::getHmac(const uint8_t *key, size_t keyLen, const uint8_t *msg, size_t msgLen) {
 	assert((key != nullptr || keyLen == 0) && (msg != nullptr || msgLen == 0));
-	
-	// Preprocess key
-	uint8_t tempKey[SHA256_BLOCK_LEN] = {};
-	if (keyLen <= SHA256_BLOCK_LEN)
-		Utils::copyBytes(tempKey, key, keyLen);
-	else {
-		const Sha256Hash keyHash(getHash(key, keyLen));
-		memcpy(tempKey, keyHash.value, SHA256_HASH_LEN);
-	}
-	
-	// Compute inner hash
-	for (int i = 0; i < SHA256_BLOCK_LEN; i++)
-		tempKey[i] ^= 0x36;
+	return getHmac(HmacSha256Key(key, keyLen), msg, msgLen);
+}
+
+
+Sha256Hash Sha256::getHmac(const HmacSha256Key &key, const uint8_t *msg, size_t msgLen) {
+	assert(msg != nullptr || msgLen == 0);
+	const Sha256Hash innerHash(getHash(msg, msgLen, key.innerState, SHA256_BLOCK_LEN));
+	return getHash(innerHash.value, SHA256_HASH_LEN, key.outerState, SHA256_BLOCK_LEN);
+}
+
+
+Sha256Hash Sha256::getTaggedHash(const char *tag, const uint8_t *msg, size_t msgLen) {
+	assert(tag != nullptr && (msg != nullptr || msgLen == 0));
 	uint32_t state[8];
-	memcpy(state, INITIAL_STATE, sizeof(state));
-	compress(state, tempKey, SHA256_BLOCK_LEN);
-	const Sha256Hash innerHash(getHash(msg, msgLen, state, SHA256_BLOCK_LEN));
+	getTaggedMidstate(tag, state);
+	return getHash(msg, msgLen, state, SHA256_BLOCK_LEN);
+}
+
+
+void Sha256::getTaggedMidstate(const char *tag, uint32_t outState[8]) {
+	assert(tag != nullptr && outState != nullptr);
+	for (size_t i = 0; i < sizeof(TAGGED_MIDSTATES) / sizeof(TAGGED_MIDSTATES[0]); i++) {
+		if (strcmp(tag, TAGGED_MIDSTATES[i].tag) == 0) {
+			memcpy(outState, TAGGED_MIDSTATES[i].state, sizeof(TAGGED_MIDSTATES[i].state));
+			return;
+		}
+	}
 	
-	// Compute outer hash
-	for (int i = 0; i < SHA256_BLOCK_LEN; i++)
-		tempKey[i] ^= 0x36 ^ 0x5C;
-	memcpy(state, INITIAL_STATE, sizeof(state));
-	compress(state, tempKey, SHA256_BLOCK_LEN);
-	return getHash(innerHash.value, SHA256_HASH_LEN, state, SHA256_BLOCK_LEN);
+	// Nonstandard tag
+	const Sha256Hash tagHash(getHash(reinterpret_cast<const uint8_t*>(tag), strlen(tag)));
+	uint8_t block[SHA256_BLOCK_LEN];
+	memcpy(&block[0], tagHash.value, SHA256_HASH_LEN);
+	memcpy(&block[SHA256_HASH_LEN], tagHash.value, SHA256_HASH_LEN);
+	memcpy(outState, INITIAL_STATE, sizeof(INITIAL_STATE));
+	compress(outState, block, SHA256_BLOCK_LEN);
 }
 
 
@@ -80,7 +138,65 @@ Sha256Hash Sha256::getHash(const uint8_t *msg, size_t len, const uint32_t initSt
 	for (int i = 1; i < 8; i++, len >>= 8)
 		block[SHA256_BLOCK_LEN - 1 - i] = static_cast<uint8_t>(len);
 	compress(state, block, SHA256_BLOCK_LEN);
-	
+	return stateToHash(state);
+}
+
+
+void Sha256::getHashMulti(const uint8_t *const msgs[], const size_t lens[], size_t len, Sha256Hash out[]) {
+	assert((msgs != nullptr && lens != nullptr && out != nullptr) || len == 0);
+	const size_t CHUNK = 32;
+	uint32_t states[CHUNK][8];
+	uint8_t tails[CHUNK][SHA256_BLOCK_LEN * 2];  // Final partial block, padding, and length
+	size_t fullBlocks[CHUNK];
+	size_t totalBlocks[CHUNK];
+	for (size_t i = 0; i < len; i += CHUNK) {
+		size_t n = len - i < CHUNK ? len - i : CHUNK;
+		size_t maxBlocks = 0;
+		for (size_t j = 0; j < n; j++) {
+			const uint8_t *msg = msgs[i + j];
+			size_t msgLen = lens[i + j];
+			assert(msg != nullptr || msgLen == 0);
+			memcpy(states[j], INITIAL_STATE, sizeof(INITIAL_STATE));
+			fullBlocks[j] = msgLen / SHA256_BLOCK_LEN;
+			totalBlocks[j] = (msgLen + 8) / SHA256_BLOCK_LEN + 1;
+			if (totalBlocks[j] > maxBlocks)
+				maxBlocks = totalBlocks[j];
+			
+			uint8_t *tail = tails[j];
+			memset(tail, 0, sizeof(tails[j]));
+			size_t off = fullBlocks[j] * SHA256_BLOCK_LEN;
+			Utils::copyBytes(tail, &msg[off], msgLen - off);
+			tail[msgLen - off] = 0x80;
+			uint64_t bitLength = static_cast<uint64_t>(msgLen) << 3;
+			size_t end = (totalBlocks[j] - fullBlocks[j]) * SHA256_BLOCK_LEN;
+			for (int k = 1; k <= 8; k++, bitLength >>= 8)
+				tail[end - k] = static_cast<uint8_t>(bitLength);
+		}
+		
+		// Each step compresses the next block of every message that still has one
+		for (size_t k = 0; k < maxBlocks; k++) {
+			uint32_t *statePtrs[CHUNK];
+			const uint8_t *blockPtrs[CHUNK];
+			size_t m = 0;
+			for (size_t j = 0; j < n; j++) {
+				if (k >= totalBlocks[j])
+					continue;
+				statePtrs[m] = states[j];
+				if (k < fullBlocks[j])
+					blockPtrs[m] = &msgs[i + j][k * SHA256_BLOCK_LEN];
+				else
+					blockPtrs[m] = &tails[j][(k - fullBlocks[j]) * SHA256_BLOCK_LEN];
+				m++;
+			}
+			compressMulti(statePtrs, blockPtrs, m);
+		}
+		for (size_t j = 0; j < n; j++)
+			out[i + j] = stateToHash(states[j]);
+	}
+}
+
+
+Sha256Hash Sha256::stateToHash(const uint32_t state[8]) {
 	// Uint32 array to bytes in big endian
 	uint8_t result[SHA256_HASH_LEN];
 	for (int i = 0; i < SHA256_HASH_LEN; i++)
@@ -92,6 +208,22 @@ Sha256Hash Sha256::getHash(const uint8_t *msg, size_t len, const uint32_t initSt
 void Sha256::compress(uint32_t state[8], const uint8_t *blocks, size_t len) {
 	assert(state != nullptr && (blocks != nullptr || len == 0));
 	assert(len % SHA256_BLOCK_LEN == 0);
+	static const CompressFunc func = selectCompress();  // Thread-safe initialization since C++11
+	func(state, blocks, len);
+}
+
+
+Sha256::CompressFunc Sha256::selectCompress() {
+#ifdef USE_X86_INTRINSICS
+	const Utils::CpuFeatures &cpu = Utils::getCpuFeatures();
+	if (cpu.sha && cpu.sse41)
+		return compressShaNi;
+#endif
+	return compressPortable;
+}
+
+
+void Sha256::compressPortable(uint32_t state[8], const uint8_t *blocks, size_t len) {
 	uint32_t schedule[64];
 	for (size_t i = 0; i < len; ) {
 		
@@ -142,6 +274,293 @@ void Sha256::compress(uint32_t state[8], const uint8_t *blocks, size_t len) {
 }
 
 
+#ifdef USE_X86_INTRINSICS
+
+__attribute__((target("sha,sse4.1")))
+void Sha256::compressShaNi(uint32_t state[8], const uint8_t *blocks, size_t len) {
+	// The SHA instructions work on the state split into the word orders (A,B,E,F) and (C,D,G,H)
+	const __m128i byteSwap = _mm_set_epi64x(INT64_C(0x0C0D0E0F08090A0B), INT64_C(0x0405060700010203));
+	__m128i temp = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[0])), 0xB1);  // CDAB
+	__m128i state1 = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&state[4])), 0x1B);  // EFGH
+	__m128i state0 = _mm_alignr_epi8(temp, state1, 8);  // ABEF
+	state1 = _mm_blend_epi16(state1, temp, 0xF0);  // CDGH
+	
+	for (size_t i = 0; i < len; i += SHA256_BLOCK_LEN) {
+		__m128i abefSave = state0;
+		__m128i cdghSave = state1;
+		
+		// Each group of 4 rounds uses 4 schedule words, kept in a ring of the last 16 words
+		__m128i msgs[4];
+		for (int j = 0; j < 16; j++) {
+			__m128i &msg = msgs[j & 3];
+			if (j < 4) {
+				msg = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&blocks[i + j * 16])), byteSwap);
+			} else {
+				// W[j] = msg2(msg1(W[j - 4], W[j - 3]) + W[j - 1 .. j - 2 shifted by 1 word], W[j - 1])
+				__m128i prev = msgs[(j - 1) & 3];
+				msg = _mm_sha256msg1_epu32(msg, msgs[(j - 3) & 3]);
+				msg = _mm_add_epi32(msg, _mm_alignr_epi8(prev, msgs[(j - 2) & 3], 4));
+				msg = _mm_sha256msg2_epu32(msg, prev);
+			}
+			__m128i wk = _mm_add_epi32(msg, _mm_loadu_si128(reinterpret_cast<const __m128i*>(&ROUND_CONSTANTS[j * 4])));
+			state1 = _mm_sha256rnds2_epu32(state1, state0, wk);
+			state0 = _mm_sha256rnds2_epu32(state0, state1, _mm_shuffle_epi32(wk, 0x0E));
+		}
+		
+		state0 = _mm_add_epi32(state0, abefSave);
+		state1 = _mm_add_epi32(state1, cdghSave);
+	}
+	
+	temp = _mm_shuffle_epi32(state0, 0x1B);  // FEBA
+	state1 = _mm_shuffle_epi32(state1, 0xB1);  // DCHG
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(&state[0]), _mm_blend_epi16(temp, state1, 0xF0));  // DCBA
+	_mm_storeu_si128(reinterpret_cast<__m128i*>(&state[4]), _mm_alignr_epi8(state1, temp, 8));  // HGFE
+}
+
+#endif
+
+
+void Sha256::compressMulti(uint32_t *const states[], const uint8_t *const blocks[], size_t len) {
+	assert((states != nullptr && blocks != nullptr) || len == 0);
+	static const CompressMultiFunc func = selectCompressMulti();  // Thread-safe initialization since C++11
+	func(states, blocks, len);
+}
+
+
+Sha256::CompressMultiFunc Sha256::selectCompressMulti() {
+#ifdef USE_X86_INTRINSICS
+	// One SHA extension compression per block beats 8 lanes of general-purpose vector arithmetic
+	const Utils::CpuFeatures &cpu = Utils::getCpuFeatures();
+	if (cpu.sha && cpu.sse41)
+		return compressMultiSerial;
+	if (cpu.avx2)
+		return compressMultiAvx2;
+	if (cpu.sse41)
+		return compressMultiSse41;
+#endif
+	return compressMultiSerial;
+}
+
+
+void Sha256::compressMultiSerial(uint32_t *const states[], const uint8_t *const blocks[], size_t len) {
+	for (size_t i = 0; i < len; i++)
+		compress(states[i], blocks[i], SHA256_BLOCK_LEN);
+}
+
+
+#ifdef USE_X86_INTRINSICS
+
+// Rotates every 32-bit element of the vector right. Requires 1 <= i <= 31.
+#define ROTR_LANES(x, i)  (((x) >> (i)) | ((x) << (32 - (i))))
+
+
+// Runs the 64 rounds on the given state vectors and adds the result into them, where element k of every
+// vector belongs to the k-th lane. If PRESCHEDULED is false, then words holds the round constants and the
+// schedule ring is expanded in place from its 16 initial words; otherwise words holds the round constants
+// already summed with a fixed schedule, and the schedule array is not used.
+template <typename Vec, bool PRESCHEDULED>
+static INLINE_LANES void roundsLanes(Vec state[8], Vec schedule[16], const uint32_t words[64]) {
+	Vec a = state[0];
+	Vec b = state[1];
+	Vec c = state[2];
+	Vec d = state[3];
+	Vec e = state[4];
+	Vec f = state[5];
+	Vec g = state[6];
+	Vec h = state[7];
+	for (int j = 0; j < 64; j++) {
+		Vec t1 = h + (ROTR_LANES(e, 6) ^ ROTR_LANES(e, 11) ^ ROTR_LANES(e, 25)) + (g ^ (e & (f ^ g))) + words[j];
+		if (!PRESCHEDULED) {
+			if (j >= 16) {
+				Vec w15 = schedule[(j - 15) & 15];
+				Vec w2 = schedule[(j - 2) & 15];
+				schedule[j & 15] += schedule[(j - 7) & 15]
+					+ (ROTR_LANES(w15,  7) ^ ROTR_LANES(w15, 18) ^ (w15 >>  3))
+					+ (ROTR_LANES(w2 , 17) ^ ROTR_LANES(w2 , 19) ^ (w2  >> 10));
+			}
+			t1 += schedule[j & 15];
+		}
+		Vec t2 = (ROTR_LANES(a, 2) ^ ROTR_LANES(a, 13) ^ ROTR_LANES(a, 22)) + ((a & (b | c)) | (b & c));
+		h = g;
+		g = f;
+		f = e;
+		e = d + t1;
+		d = c;
+		c = b;
+		b = a;
+		a = t1 + t2;
+	}
+	state[0] += a;
+	state[1] += b;
+	state[2] += c;
+	state[3] += d;
+	state[4] += e;
+	state[5] += f;
+	state[6] += g;
+	state[7] += h;
+}
+
+
+// Loads 16 big-endian words from each lane's block into transposed schedule vectors.
+template <typename Vec, int LANES>
+static INLINE_LANES void loadScheduleLanes(Vec schedule[16], const uint8_t *const blocks[LANES]) {
+	for (int j = 0; j < 16; j++) {
+		for (int k = 0; k < LANES; k++) {
+			const uint8_t *b = &blocks[k][j * 4];
+			schedule[j][k] = static_cast<uint32_t>(b[0]) << 24
+			               | static_cast<uint32_t>(b[1]) << 16
+			               | static_cast<uint32_t>(b[2]) <<  8
+			               | static_cast<uint32_t>(b[3]) <<  0;
+		}
+	}
+}
+
+
+// Compresses one block into each of the given states, LANES at a time. A final partial group is padded with dummy lanes.
+template <typename Vec, int LANES>
+static INLINE_LANES void compressLanes(
+		uint32_t *const states[], const uint8_t *const blocks[], size_t len, const uint32_t roundConstants[64]) {
+	uint32_t dummyState[8] = {};
+	const uint8_t dummyBlock[SHA256_BLOCK_LEN] = {};
+	for (size_t i = 0; i < len; i += LANES) {
+		uint32_t *laneStates[LANES];
+		const uint8_t *laneBlocks[LANES];
+		for (int k = 0; k < LANES; k++) {
+			bool active = i + k < len;
+			laneStates[k] = active ? states[i + k] : dummyState;
+			laneBlocks[k] = active ? blocks[i + k] : dummyBlock;
+		}
+		
+		Vec state[8];
+		Vec schedule[16];
+		for (int j = 0; j < 8; j++) {
+			for (int k = 0; k < LANES; k++)
+				state[j][k] = laneStates[k][j];
+		}
+		loadScheduleLanes<Vec, LANES>(schedule, laneBlocks);
+		roundsLanes<Vec, false>(state, schedule, roundConstants);
+		for (int j = 0; j < 8; j++) {
+			for (int k = 0; k < LANES; k++)
+				laneStates[k][j] = state[j][k];
+		}
+	}
+}
+
+
+// Computes the double SHA-256 hashes of the first (len / LANES * LANES) consecutive 64-byte messages, LANES at a time.
+// The second block of the first hash uses the fixed padding round words, and the second hash starts
+// directly from the first hash's state words without serializing them to bytes.
+template <typename Vec, int LANES>
+static INLINE_LANES void doubleHash64Lanes(const uint8_t msgs[], size_t len, Sha256Hash out[],
+		const uint32_t initState[8], const uint32_t roundConstants[64], const uint32_t paddingRoundWords[64]) {
+	const Vec zero = {};
+	for (size_t i = 0; i + LANES <= len; i += LANES) {
+		const uint8_t *laneBlocks[LANES];
+		for (int k = 0; k < LANES; k++)
+			laneBlocks[k] = &msgs[(i + k) * SHA256_BLOCK_LEN];
+		
+		// First hash: the message block, then the fixed padding block
+		Vec state[8];
+		Vec schedule[16];
+		for (int j = 0; j < 8; j++)
+			state[j] = zero + initState[j];
+		loadScheduleLanes<Vec, LANES>(schedule, laneBlocks);
+		roundsLanes<Vec, false>(state, schedule, roundConstants);
+		roundsLanes<Vec, true>(state, schedule, paddingRoundWords);
+		
+		// Second hash: the 32-byte hash, then its padding and length of 256 bits
+		for (int j = 0; j < 8; j++) {
+			schedule[j] = state[j];
+			state[j] = zero + initState[j];
+		}
+		schedule[8] = zero + UINT32_C(0x80000000);
+		for (int j = 9; j < 15; j++)
+			schedule[j] = zero;
+		schedule[15] = zero + UINT32_C(256);
+		roundsLanes<Vec, false>(state, schedule, roundConstants);
+		
+		// Uint32 vectors to bytes in big endian, after all of this group's input has been read
+		for (int k = 0; k < LANES; k++) {
+			uint8_t *b = out[i + k].value;
+			for (int j = 0; j < SHA256_HASH_LEN; j++)
+				b[j] = static_cast<uint8_t>(state[j >> 2][k] >> ((3 - (j & 3)) << 3));
+		}
+	}
+}
+
+#undef ROTR_LANES
+
+
+typedef uint32_t Uint32x4 __attribute__((vector_size(16)));
+typedef uint32_t Uint32x8 __attribute__((vector_size(32)));
+
+
+__attribute__((target("sse4.1")))
+void Sha256::compressMultiSse41(uint32_t *const states[], const uint8_t *const blocks[], size_t len) {
+	compressLanes<Uint32x4, 4>(states, blocks, len, ROUND_CONSTANTS);
+}
+
+
+__attribute__((target("avx2")))
+void Sha256::compressMultiAvx2(uint32_t *const states[], const uint8_t *const blocks[], size_t len) {
+	compressLanes<Uint32x8, 8>(states, blocks, len, ROUND_CONSTANTS);
+}
+
+#endif
+
+
+Sha256::DoubleHash64Func Sha256::selectDoubleHash64() {
+#ifdef USE_X86_INTRINSICS
+	const Utils::CpuFeatures &cpu = Utils::getCpuFeatures();
+	if (cpu.avx2)
+		return getDoubleHash64Avx2;
+	if (cpu.sha && cpu.sse41)
+		return getDoubleHash64Serial;
+	if (cpu.sse41)
+		return getDoubleHash64Sse41;
+#endif
+	return getDoubleHash64Serial;
+}
+
+
+void Sha256::getDoubleHash64Serial(const uint8_t msgs[], size_t len, Sha256Hash out[]) {
+	for (size_t i = 0; i < len; i++) {
+		uint32_t state[8];
+		memcpy(state, INITIAL_STATE, sizeof(state));
+		compress(state, &msgs[i * SHA256_BLOCK_LEN], SHA256_BLOCK_LEN);
+		compress(state, PADDING_BLOCK_64, SHA256_BLOCK_LEN);
+		
+		uint8_t block[SHA256_BLOCK_LEN];
+		for (int j = 0; j < SHA256_HASH_LEN; j++)
+			block[j] = static_cast<uint8_t>(state[j >> 2] >> ((3 - (j & 3)) << 3));
+		memcpy(&block[SHA256_HASH_LEN], PADDING_TAIL_32, sizeof(PADDING_TAIL_32));
+		memcpy(state, INITIAL_STATE, sizeof(state));
+		compress(state, block, SHA256_BLOCK_LEN);
+		out[i] = stateToHash(state);
+	}
+}
+
+
+#ifdef USE_X86_INTRINSICS
+
+__attribute__((target("sse4.1")))
+void Sha256::getDoubleHash64Sse41(const uint8_t msgs[], size_t len, Sha256Hash out[]) {
+	doubleHash64Lanes<Uint32x4, 4>(msgs, len, out, INITIAL_STATE, ROUND_CONSTANTS, PADDING_ROUND_WORDS_64);
+	size_t done = len / 4 * 4;
+	getDoubleHash64Serial(&msgs[done * SHA256_BLOCK_LEN], len - done, &out[done]);
+}
+
+
+__attribute__((target("avx2")))
+void Sha256::getDoubleHash64Avx2(const uint8_t msgs[], size_t len, Sha256Hash out[]) {
+	doubleHash64Lanes<Uint32x8, 8>(msgs, len, out, INITIAL_STATE, ROUND_CONSTANTS, PADDING_ROUND_WORDS_64);
+	size_t done = len / 8 * 8;
+	getDoubleHash64Serial(&msgs[done * SHA256_BLOCK_LEN], len - done, &out[done]);
+}
+
+#endif
+
+
 Sha256::Sha256() :
 		length(0),
 		buffer(),
@@ -150,35 +569,65 @@ Sha256::Sha256() :
 }
 
 
+Sha256::Sha256(const uint32_t midstate[8], uint64_t length_) :
+		length(length_),
+		buffer(),
+		bufferLen(0) {
+	assert(midstate != nullptr && length_ % SHA256_BLOCK_LEN == 0);
+	memcpy(state, midstate, sizeof(state));
+}
+
+
 void Sha256::append(const uint8_t *bytes, size_t len) {
 	assert(bytes != nullptr || len == 0);
-	for (size_t i = 0; i < len; i++) {
-		buffer[bufferLen] = bytes[i];
-		bufferLen++;
-		if (bufferLen == SHA256_BLOCK_LEN) {
-			compress(state, buffer, SHA256_BLOCK_LEN);
-			bufferLen = 0;
-		}
-	}
 	length += len;
+	
+	// Top up a partially filled buffer
+	if (bufferLen > 0) {
+		size_t n = SHA256_BLOCK_LEN - static_cast<size_t>(bufferLen);
+		if (n > len)
+			n = len;
+		Utils::copyBytes(&buffer[bufferLen], bytes, n);
+		bufferLen += static_cast<int>(n);
+		bytes += n;
+		len -= n;
+		if (bufferLen < SHA256_BLOCK_LEN)
+			return;
+		compress(state, buffer, SHA256_BLOCK_LEN);
+		bufferLen = 0;
+	}
+	
+	// Compress whole blocks straight from the input, and buffer the rest
+	size_t wholeLen = len & ~static_cast<size_t>(SHA256_BLOCK_LEN - 1);
+	compress(state, bytes, wholeLen);
+	Utils::copyBytes(buffer, bytes + wholeLen, len - wholeLen);
+	bufferLen = static_cast<int>(len - wholeLen);
 }
 
 
-Sha256Hash Sha256::getHash() {
+bool Sha256::getMidstate(uint32_t outState[8], uint64_t &outLength) const {
+	assert(outState != nullptr);
+	if (bufferLen != 0)
+		return false;
+	memcpy(outState, state, sizeof(state));
+	outLength = length;
+	return true;
+}
+
+
+Sha256Hash Sha256::getHash() const {
+	// Pad the buffered bytes into one or two final blocks, compressed into a copy of the state
+	uint32_t tempState[8];
+	memcpy(tempState, state, sizeof(tempState));
+	uint8_t blocks[SHA256_BLOCK_LEN * 2] = {};
+	memcpy(blocks, buffer, static_cast<size_t>(bufferLen));
+	blocks[bufferLen] = 0x80;
+	size_t blocksLen = bufferLen + 9 <= SHA256_BLOCK_LEN ? SHA256_BLOCK_LEN : SHA256_BLOCK_LEN * 2;
 	uint64_t bitLength = length << 3;
-	uint8_t temp = 0x80;
-	append(&temp, 1);
-	temp = 0x00;
-	while (bufferLen != 56)
-		append(&temp, 1);
-	for (int i = 0; i < 8; i++) {
-		temp = static_cast<uint8_t>(bitLength >> ((7 - i) << 3));
-		append(&temp, 1);
-	}
-	uint8_t result[SHA256_HASH_LEN];
-	for (int i = 0; i < SHA256_HASH_LEN; i++)
-		result[i] = static_cast<uint8_t>(state[i >> 2] >> ((3 - (i & 3)) << 3));
-	return Sha256Hash(result, SHA256_HASH_LEN);
+	for (int i = 1; i <= 8; i++, bitLength >>= 8)
+		blocks[blocksLen - i] = static_cast<uint8_t>(bitLength);
+	compress(tempState, blocks, blocksLen);
+	return stateToHash(tempState);
 }
 
 
@@ -205,6 +654,64 @@ const uint32_t Sha256::ROUND_CONSTANTS[64] = {
 	UINT32_C(0x748F82EE), UINT32_C(0x78A5636F), UINT32_C(0x84C87814), UINT32_C(0x8CC70208),
 	UINT32_C(0x90BEFFFA), UINT32_C(0xA4506CEB), UINT32_C(0xBEF9A3F7), UINT32_C(0xC67178F2),
 };
+const uint8_t Sha256::PADDING_BLOCK_64[SHA256_BLOCK_LEN] = {
+	0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x00,
+};
+const uint8_t Sha256::PADDING_TAIL_32[SHA256_BLOCK_LEN - SHA256_HASH_LEN] = {
+	0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00,
+};
+const uint32_t Sha256::PADDING_ROUND_WORDS_64[64] = {
+	UINT32_C(0xC28A2F98), UINT32_C(0x71374491), UINT32_C(0xB5C0FBCF), UINT32_C(0xE9B5DBA5),
+	UINT32_C(0x3956C25B), UINT32_C(0x59F111F1), UINT32_C(0x923F82A4), UINT32_C(0xAB1C5ED5),
+	UINT32_C(0xD807AA98), UINT32_C(0x12835B01), UINT32_C(0x243185BE), UINT32_C(0x550C7DC3),
+	UINT32_C(0x72BE5D74), UINT32_C(0x80DEB1FE), UINT32_C(0x9BDC06A7), UINT32_C(0xC19BF374),
+	UINT32_C(0x649B69C1), UINT32_C(0xF0FE4786), UINT32_C(0x0FE1EDC6), UINT32_C(0x240CF254),
+	UINT32_C(0x4FE9346F), UINT32_C(0x6CC984BE), UINT32_C(0x61B9411E), UINT32_C(0x16F988FA),
+	UINT32_C(0xF2C65152), UINT32_C(0xA88E5A6D), UINT32_C(0xB019FC65), UINT32_C(0xB9D99EC7),
+	UINT32_C(0x9A1231C3), UINT32_C(0xE70EEAA0), UINT32_C(0xFDB1232B), UINT32_C(0xC7353EB0),
+	UINT32_C(0x3069BAD5), UINT32_C(0xCB976D5F), UINT32_C(0x5A0F118F), UINT32_C(0xDC1EEEFD),
+	UINT32_C(0x0A35B689), UINT32_C(0xDE0B7A04), UINT32_C(0x58F4CA9D), UINT32_C(0xE15D5B16),
+	UINT32_C(0x007F3E86), UINT32_C(0x37088980), UINT32_C(0xA507EA32), UINT32_C(0x6FAB9537),
+	UINT32_C(0x17406110), UINT32_C(0x0D8CD6F1), UINT32_C(0xCDAA3B6D), UINT32_C(0xC0BBBE37),
+	UINT32_C(0x83613BDA), UINT32_C(0xDB48A363), UINT32_C(0x0B02E931), UINT32_C(0x6FD15CA7),
+	UINT32_C(0x521AFACA), UINT32_C(0x31338431), UINT32_C(0x6ED41A95), UINT32_C(0x6D437890),
+	UINT32_C(0xC39C91F2), UINT32_C(0x9ECCABBD), UINT32_C(0xB5C9A0E6), UINT32_C(0x532FB63C),
+	UINT32_C(0xD2C741C6), UINT32_C(0x07237EA3), UINT32_C(0xA4954B68), UINT32_C(0x4C191D76),
+};
+const Sha256::TaggedMidstate Sha256::TAGGED_MIDSTATES[7] = {
+	{"BIP0340/aux", {
+		UINT32_C(0x24DD3219), UINT32_C(0x4EBA7E70), UINT32_C(0xCA0FABB9), UINT32_C(0x0FA3166D),
+		UINT32_C(0x3AFBE4B1), UINT32_C(0x4C44DF97), UINT32_C(0x4AAC2739), UINT32_C(0x249E850A),
+	}},
+	{"BIP0340/challenge", {
+		UINT32_C(0x9CECBA11), UINT32_C(0x23925381), UINT32_C(0x11679112), UINT32_C(0xD1627E0F),
+		UINT32_C(0x97C87550), UINT32_C(0x003CC765), UINT32_C(0x90F61164), UINT32_C(0x33E9B66A),
+	}},
+	{"BIP0340/nonce", {
+		UINT32_C(0x46615B35), UINT32_C(0xF4BFBFF7), UINT32_C(0x9F8DC671), UINT32_C(0x83627AB3),
+		UINT32_C(0x60217180), UINT32_C(0x57358661), UINT32_C(0x21A29E54), UINT32_C(0x68B07B4C),
+	}},
+	{"TapBranch", {
+		UINT32_C(0x23A865A9), UINT32_C(0xB8A40DA7), UINT32_C(0x977C1E04), UINT32_C(0xC49E246F),
+		UINT32_C(0xB5BE1376), UINT32_C(0x9D24C9B7), UINT32_C(0xB583B5D4), UINT32_C(0xA8D226D2),
+	}},
+	{"TapLeaf", {
+		UINT32_C(0x9CE0E4E6), UINT32_C(0x7C116C39), UINT32_C(0x38B3CAF2), UINT32_C(0xC30F5089),
+		UINT32_C(0xD3F3936C), UINT32_C(0x47636E60), UINT32_C(0x7DB33EEA), UINT32_C(0xDDC6F0C9),
+	}},
+	{"TapSighash", {
+		UINT32_C(0xF504A425), UINT32_C(0xD7F8783B), UINT32_C(0x1363868A), UINT32_C(0xE3E55658),
+		UINT32_C(0x6EEE945D), UINT32_C(0xBC7888DD), UINT32_C(0x02A6E2C3), UINT32_C(0x1873FE9F),
+	}},
+	{"TapTweak", {
+		UINT32_C(0xD129A2F3), UINT32_C(0x701C655D), UINT32_C(0x6583B6C3), UINT32_C(0xB9419727),
+		UINT32_C(0x95F4E232), UINT32_C(0x94FD54F4), UINT32_C(0xA2AE8D85), UINT32_C(0x47CA590B),
+	}},
+};
 
 
 // Requires 1 <= i <= 31
@@ -13,9 +13,26 @@
 #include "Sha256Hash.hpp"
 
 
+/* 
+ * The HMAC-SHA-256 states for one key, after compressing its inner and outer padded key blocks.
+ * A key context can be passed to Sha256::getHmac() any number of times to avoid rekeying,
+ * which suits deterministic nonces where one private key signs many messages.
+ */
+struct HmacSha256Key final {
+	
+	uint32_t innerState[8];
+	uint32_t outerState[8];
+	
+	
+	HmacSha256Key(const uint8_t *key, size_t keyLen);
+	
+};
+
+
+
 /* 
  * Computes the SHA-256 hash of a sequence of bytes, returning a Sha256Hash object.
- * Provides three static methods, and an instantiable stateful hasher.
+ * Provides a few static methods, and an instantiable stateful hasher.
  */
 #define SHA256_BLOCK_LEN 64
 class Sha256 final {
@@ -30,17 +47,97 @@ public:
 	static Sha256Hash getDoubleHash(const uint8_t *msg, size_t len);
 	
 	
+	// Computes the double SHA-256 hash of exactly one 64-byte message, such as a pair of Merkle tree nodes.
+	static Sha256Hash getDoubleHash64(const uint8_t msg[SHA256_BLOCK_LEN]);
+	
+	
+	// Computes the double SHA-256 hashes of the given number of consecutive 64-byte messages, such that
+	// out[i] = getDoubleHash(&msgs[i * 64], 64). The output array may start at the same address as the input
+	// array, which reduces a level of Merkle tree nodes in place. Uses parallel SIMD lanes if supported.
+	static void getDoubleHash64Multi(const uint8_t msgs[], size_t len, Sha256Hash out[]);
+	
+	
 	static Sha256Hash getHmac(const uint8_t *key, size_t keyLen, const uint8_t *msg, size_t msgLen);
 	
 	
+	// Computes the HMAC of the given message with the given precomputed key context.
+	static Sha256Hash getHmac(const HmacSha256Key &key, const uint8_t *msg, size_t msgLen);
+	
+	
+	// Computes the BIP340 tagged hash SHA256(SHA256(tag) || SHA256(tag) || msg) for the given null-terminated tag.
+	// The standard BIP340 and Taproot tags use precomputed midstates, which saves one compression per call.
+	static Sha256Hash getTaggedHash(const char *tag, const uint8_t *msg, size_t msgLen);
+	
+	
+	// Writes the state after compressing the 64-byte tag prefix, for use with the resuming hasher
+	// constructor Sha256(outState, SHA256_BLOCK_LEN) when the message is streamed in pieces.
+	static void getTaggedMidstate(const char *tag, uint32_t outState[8]);
+	
+	
+	// Computes the hashes of the given number of independent messages, such that out[i] = getHash(msgs[i], lens[i]).
+	// The messages may have different lengths, but throughput is best when the lengths are similar.
+	static void getHashMulti(const uint8_t *const msgs[], const size_t lens[], size_t len, Sha256Hash out[]);
+	
+	
 private:
 	static Sha256Hash getHash(const uint8_t *msg, size_t len, const uint32_t initState[8], size_t prefixLen);
 	
+	static Sha256Hash stateToHash(const uint32_t state[8]);
+	
 	
 public:
+	// Compresses whole blocks into the given state. Uses the SHA instruction set extensions
+	// if the CPU supports them (detected once), or else the portable implementation.
 	static void compress(uint32_t state[8], const uint8_t *blocks, size_t len);
 	
 	
+private:
+	typedef void (*CompressFunc)(uint32_t state[8], const uint8_t *blocks, size_t len);
+	
+	static CompressFunc selectCompress();
+	
+	static void compressPortable(uint32_t state[8], const uint8_t *blocks, size_t len);
+	
+	// Only defined if USE_X86_INTRINSICS is defined.
+	static void compressShaNi(uint32_t state[8], const uint8_t *blocks, size_t len);
+	
+	
+public:
+	// Compresses exactly one block into each state, such that the effect is equivalent to calling
+	// compress(states[i], blocks[i], SHA256_BLOCK_LEN) for each i. Processes 8 (AVX2) or 4 (SSE4.1)
+	// states in parallel SIMD lanes if the CPU supports them, or else calls compress() in a loop.
+	static void compressMulti(uint32_t *const states[], const uint8_t *const blocks[], size_t len);
+	
+	
+private:
+	typedef void (*CompressMultiFunc)(uint32_t *const states[], const uint8_t *const blocks[], size_t len);
+	
+	static CompressMultiFunc selectCompressMulti();
+	
+	static void compressMultiSerial(uint32_t *const states[], const uint8_t *const blocks[], size_t len);
+	
+	// Only defined if USE_X86_INTRINSICS is defined.
+	static void compressMultiSse41(uint32_t *const states[], const uint8_t *const blocks[], size_t len);
+	
+	// Only defined if USE_X86_INTRINSICS is defined.
+	static void compressMultiAvx2(uint32_t *const states[], const uint8_t *const blocks[], size_t len);
+	
+	// Lets the test suite call every kernel that the CPU supports, not just the selected one.
+	friend class Sha256Test;
+	
+	typedef void (*DoubleHash64Func)(const uint8_t msgs[], size_t len, Sha256Hash out[]);
+	
+	static DoubleHash64Func selectDoubleHash64();
+	
+	static void getDoubleHash64Serial(const uint8_t msgs[], size_t len, Sha256Hash out[]);
+	
+	// Only defined if USE_X86_INTRINSICS is defined.
+	static void getDoubleHash64Sse41(const uint8_t msgs[], size_t len, Sha256Hash out[]);
+	
+	// Only defined if USE_X86_INTRINSICS is defined.
+	static void getDoubleHash64Avx2(const uint8_t msgs[], size_t len, Sha256Hash out[]);
+	
+	
 	
 	/*---- Stateful hasher fields and methods ----*/
 	
@@ -52,16 +149,31 @@ private:
 	
 	
 public:
-	// Constructs a new SHA-256 hasher with an initially blank message.
+	// Constructs a new SHA-256 hasher with an initially blank message. Hashers are copyable, so a copy
+	// taken after appending a common prefix is a snapshot that can be resumed any number of times.
 	Sha256();
 	
 	
-	// Appends message bytes to this ongoing hasher.
+	// Constructs a SHA-256 hasher that resumes from the given midstate, which came from getMidstate()
+	// or from compressing whole blocks (such as the states of HmacSha256Key). The length is the number of message
+	// bytes already compressed into the midstate, and must be a multiple of SHA256_BLOCK_LEN.
+	Sha256(const uint32_t midstate[8], uint64_t length_);
+	
+	
+	// Appends message bytes to this ongoing hasher. Whole blocks are compressed directly from the given array,
+	// so appending large runs (ideally multiples of SHA256_BLOCK_LEN) avoids copying through the buffer.
 	void append(const uint8_t *bytes, size_t len);
 	
 	
-	// Returns the SHA-256 hash of all the bytes seen. Destroys the state so that no further append() or getHash() will be valid.
-	Sha256Hash getHash();
+	// If the number of bytes seen is a multiple of SHA256_BLOCK_LEN (so nothing is buffered), then this
+	// writes the compression state and the number of bytes seen, and returns true. Otherwise this
+	// returns false and leaves the outputs unchanged; a copy of the hasher serves as the snapshot instead.
+	bool getMidstate(uint32_t outState[8], uint64_t &outLength) const;
+	
+	
+	// Returns the SHA-256 hash of all the bytes seen. Doesn't change this hasher, so
+	// more bytes can be appended and getHash() can be called again afterward.
+	Sha256Hash getHash() const;
 	
 	
 	
@@ -69,7 +181,21 @@ public:
 	
 public:
 	static const uint32_t INITIAL_STATE[8];
-private:
 	static const uint32_t ROUND_CONSTANTS[64];
+private:
+	
+	// The padding block that follows a 64-byte message, and the padding that follows a 32-byte message.
+	static const uint8_t PADDING_BLOCK_64[SHA256_BLOCK_LEN];
+	static const uint8_t PADDING_TAIL_32[SHA256_BLOCK_LEN - SHA256_HASH_LEN];
+	
+	// ROUND_CONSTANTS[i] plus schedule word i of PADDING_BLOCK_64, which never needs to be expanded again.
+	static const uint32_t PADDING_ROUND_WORDS_64[64];
+	
+	// The states after compressing SHA256(tag) || SHA256(tag) for the standard BIP340 and Taproot tags.
+	struct TaggedMidstate {
+		const char *tag;
+		uint32_t state[8];
+	};
+	static const TaggedMidstate TAGGED_MIDSTATES[7];
 	
 };
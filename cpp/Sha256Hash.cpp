@@ -12,6 +12,10 @@
 #include "Utils.hpp"
 
 
+Sha256Hash::Sha256Hash() :
+	value() {}
+
+
 Sha256Hash::Sha256Hash(const uint8_t hash[SHA256_HASH_LEN], size_t len) {
 	assert(hash != nullptr && len == SHA256_HASH_LEN);
 	memcpy(value, hash, sizeof(value));
@@ -34,6 +34,11 @@ public:
 	
 	/*---- Constructors ----*/
 	
+	// Constructs a Sha256Hash of all zero bytes. Constant-time. For clarity, only use this
+	// constructor if the value will be overwritten immediately (such as for an output array).
+	Sha256Hash();
+	
+	
 	// Constructs a Sha256Hash from the given array of 32 bytes (len is a dummy parameter that must equal 32).
 	// Constant-time with respect to the given array of values.
 	Sha256Hash(const uint8_t hash[SHA256_HASH_LEN], size_t len);
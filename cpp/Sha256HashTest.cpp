@@ -53,6 +53,11 @@ int main(int argc, char **argv) {
 	assert(hash.value[31] == 0xFD);
 	numTestCases++;
 	
+	// Test default value
+	const Sha256Hash zero;
+	assert(zero == Sha256Hash("0000000000000000000000000000000000000000000000000000000000000000"));
+	numTestCases++;
+	
 	// Epilog
 	printf("All %d test cases passed\n", numTestCases);
 	return 0;
@@ -12,8 +12,10 @@
 #include <cstdio>
 #include <cstdint>
 #include <cstring>
+#include <vector>
 #include "Sha256.hpp"
 #include "Sha256Hash.hpp"
+#include "Utils.hpp"
 
 
 /*---- Structures ----*/
@@ -31,6 +33,81 @@ struct HmacCase {
 };
 
 
+// Has access to the private kernels of Sha256, because dispatch selects only one of them for the running CPU.
+class Sha256Test final {
+	
+public:
+	
+	typedef Sha256::CompressFunc CompressFunc;
+	
+	
+	// Returns the portable kernel and the SHA extensions kernel if the running CPU supports it.
+	static std::vector<CompressFunc> getCompressKernels() {
+		std::vector<CompressFunc> result;
+		result.push_back(Sha256::compressPortable);
+#ifdef USE_X86_INTRINSICS
+		const Utils::CpuFeatures &cpu = Utils::getCpuFeatures();
+		if (cpu.sha && cpu.sse41)
+			result.push_back(Sha256::compressShaNi);
+#endif
+		return result;
+	}
+	
+	
+	// Hashes the given message by padding it and compressing every block with the given kernel only.
+	static Sha256Hash getHashWith(CompressFunc func, const uint8_t *msg, size_t len) {
+		std::vector<uint8_t> padded(msg, msg + len);
+		padded.push_back(0x80);
+		while (padded.size() % SHA256_BLOCK_LEN != SHA256_BLOCK_LEN - 8)
+			padded.push_back(0x00);
+		const uint64_t bitLen = static_cast<uint64_t>(len) << 3;
+		for (int i = 7; i >= 0; i--)
+			padded.push_back(static_cast<uint8_t>(bitLen >> (i * 8)));
+		uint32_t state[8];
+		memcpy(state, Sha256::INITIAL_STATE, sizeof(state));
+		func(state, padded.data(), padded.size());
+		return Sha256::stateToHash(state);
+	}
+	
+	
+	typedef Sha256::CompressMultiFunc CompressMultiFunc;
+	
+	
+	// Returns the portable kernel and every SIMD kernel that the running CPU supports.
+	static std::vector<CompressMultiFunc> getCompressMultiKernels() {
+		std::vector<CompressMultiFunc> result;
+		result.push_back(Sha256::compressMultiSerial);
+#ifdef USE_X86_INTRINSICS
+		const Utils::CpuFeatures &cpu = Utils::getCpuFeatures();
+		if (cpu.sse41)
+			result.push_back(Sha256::compressMultiSse41);
+		if (cpu.avx2)
+			result.push_back(Sha256::compressMultiAvx2);
+#endif
+		return result;
+	}
+	
+	
+	typedef Sha256::DoubleHash64Func DoubleHash64Func;
+	
+	
+	// Returns the portable kernel and every SIMD kernel that the running CPU supports.
+	static std::vector<DoubleHash64Func> getDoubleHash64Kernels() {
+		std::vector<DoubleHash64Func> result;
+		result.push_back(Sha256::getDoubleHash64Serial);
+#ifdef USE_X86_INTRINSICS
+		const Utils::CpuFeatures &cpu = Utils::getCpuFeatures();
+		if (cpu.sse41)
+			result.push_back(Sha256::getDoubleHash64Sse41);
+		if (cpu.avx2)
+			result.push_back(Sha256::getDoubleHash64Avx2);
+#endif
+		return result;
+	}
+	
+};
+
+
 /*---- Test suite ----*/
 
 static void ap(Sha256 &hasher, const char *msg) {
@@ -191,6 +268,88 @@ int main(int argc, char **argv) {
 		numTestCases++;
 	}
 	
+	// Every single-block kernel that the CPU supports, on its own, against the known answers
+	const std::vector<Sha256Test::CompressFunc> singleKernels(Sha256Test::getCompressKernels());
+	for (size_t k = 0; k < singleKernels.size(); k++) {
+		for (unsigned int i = 0; i < ARRAY_LENGTH(singleCases); i++) {
+			TestCase &tc = singleCases[i];
+			const Sha256Hash actualHash(Sha256Test::getHashWith(singleKernels[k], tc.message.data(), tc.message.size()));
+			assert((actualHash == Sha256Hash(tc.expectedHash)) == tc.matches);
+		}
+		numTestCases++;
+	}
+	
+	// Every single-block kernel versus the portable one, over several numbers of blocks per call
+	for (size_t numBlocks = 0; numBlocks <= 5; numBlocks++) {
+		uint8_t blocks[5 * SHA256_BLOCK_LEN];
+		for (size_t i = 0; i < numBlocks * SHA256_BLOCK_LEN; i++)
+			blocks[i] = static_cast<uint8_t>(i * 13 + numBlocks * 101);
+		uint32_t expectState[8];
+		for (int j = 0; j < 8; j++)
+			expectState[j] = static_cast<uint32_t>(0x9E3779B9U * (j + numBlocks + 1));
+		uint32_t initState[8];
+		memcpy(initState, expectState, sizeof(initState));
+		singleKernels[0](expectState, blocks, numBlocks * SHA256_BLOCK_LEN);
+		for (size_t k = 1; k < singleKernels.size(); k++) {
+			uint32_t state[8];
+			memcpy(state, initState, sizeof(state));
+			singleKernels[k](state, blocks, numBlocks * SHA256_BLOCK_LEN);
+			assert(memcmp(state, expectState, sizeof(state)) == 0);
+		}
+		numTestCases++;
+	}
+	
+	// Multi-buffer hashing of all the single cases at once, and of every prefix count
+	{
+		const size_t n = ARRAY_LENGTH(singleCases);
+		const uint8_t *msgs[n];
+		size_t lens[n];
+		for (size_t i = 0; i < n; i++) {
+			msgs[i] = singleCases[i].message.data();
+			lens[i] = singleCases[i].message.size();
+		}
+		for (size_t count = 0; count <= n; count += (count < 20 ? 1 : 17)) {
+			Sha256Hash hashes[n];
+			Sha256::getHashMulti(msgs, lens, count, hashes);
+			for (size_t i = 0; i < count; i++)
+				assert((hashes[i] == Sha256Hash(singleCases[i].expectedHash)) == singleCases[i].matches);
+			numTestCases++;
+		}
+	}
+	
+	// Multi-buffer compression versus single compression, for each number of lanes,
+	// through dispatch and through every kernel that the CPU supports
+	const std::vector<Sha256Test::CompressMultiFunc> compressKernels(Sha256Test::getCompressMultiKernels());
+	for (size_t count = 0; count <= 20; count++) {
+		uint8_t blocks[20][SHA256_BLOCK_LEN];
+		uint32_t initStates[20][8];
+		uint32_t expectStates[20][8];
+		const uint8_t *blockPtrs[20];
+		for (size_t i = 0; i < count; i++) {
+			for (int j = 0; j < SHA256_BLOCK_LEN; j++)
+				blocks[i][j] = static_cast<uint8_t>(i * 31 + j * 7 + count);
+			for (int j = 0; j < 8; j++)
+				initStates[i][j] = expectStates[i][j] = static_cast<uint32_t>(0x9E3779B9U * (i * 8 + j + 1));
+			blockPtrs[i] = blocks[i];
+			Sha256::compress(expectStates[i], blocks[i], SHA256_BLOCK_LEN);
+		}
+		for (size_t k = 0; k <= compressKernels.size(); k++) {
+			uint32_t states[20][8];
+			uint32_t *statePtrs[20];
+			for (size_t i = 0; i < count; i++) {
+				memcpy(states[i], initStates[i], sizeof(states[i]));
+				statePtrs[i] = states[i];
+			}
+			if (k == 0)
+				Sha256::compressMulti(statePtrs, blockPtrs, count);
+			else
+				compressKernels[k - 1](statePtrs, blockPtrs, count);
+			for (size_t i = 0; i < count; i++)
+				assert(memcmp(states[i], expectStates[i], sizeof(states[i])) == 0);
+			numTestCases++;
+		}
+	}
+	
 	// Double SHA-256 hash
 	TestCase doubleCases[] = {
 		{true, "56944C5D3F98413EF45CF54545538103CC9F298E0575820AD3591376E2E0F65D", asciiBytes("")},
@@ -206,6 +365,42 @@ int main(int argc, char **argv) {
 		numTestCases++;
 	}
 	
+	// Double hash of 64-byte messages, singly and in parallel, and in place,
+	// through dispatch and through every kernel that the CPU supports
+	const std::vector<Sha256Test::DoubleHash64Func> doubleKernels(Sha256Test::getDoubleHash64Kernels());
+	for (size_t count = 0; count <= 40; count += (count < 20 ? 1 : 10)) {
+		Bytes msgs(count * SHA256_BLOCK_LEN);
+		for (size_t i = 0; i < msgs.size(); i++)
+			msgs[i] = static_cast<uint8_t>(i * 0x35 + count);
+		Sha256Hash expectHashes[40];
+		for (size_t i = 0; i < count; i++) {
+			const Sha256Hash innerHash(Sha256::getHash(&msgs[i * SHA256_BLOCK_LEN], SHA256_BLOCK_LEN));
+			expectHashes[i] = Sha256::getHash(innerHash.value, SHA256_HASH_LEN);
+			assert(Sha256::getDoubleHash64(&msgs[i * SHA256_BLOCK_LEN]) == expectHashes[i]);
+			assert(Sha256::getDoubleHash(&msgs[i * SHA256_BLOCK_LEN], SHA256_BLOCK_LEN) == expectHashes[i]);
+		}
+		Sha256Hash hashes[40];
+		Sha256::getDoubleHash64Multi(msgs.data(), count, hashes);
+		for (size_t i = 0; i < count; i++)
+			assert(hashes[i] == expectHashes[i]);
+		numTestCases++;
+		
+		// Every kernel that the CPU supports, out of place and in place
+		for (size_t k = 0; k < doubleKernels.size(); k++) {
+			Bytes temp(msgs);
+			doubleKernels[k](temp.data(), count, hashes);
+			Sha256Hash *inPlace = reinterpret_cast<Sha256Hash*>(temp.data());
+			doubleKernels[k](temp.data(), count, inPlace);
+			for (size_t i = 0; i < count; i++)
+				assert(hashes[i] == expectHashes[i] && inPlace[i] == expectHashes[i]);
+			numTestCases++;
+		}
+		Sha256Hash *inPlace = reinterpret_cast<Sha256Hash*>(msgs.data());
+		Sha256::getDoubleHash64Multi(msgs.data(), count, inPlace);
+		for (size_t i = 0; i < count; i++)
+			assert(inPlace[i] == expectHashes[i]);
+	}
+	
 	// HMAC-SHA-256 message authentication code
 	HmacCase hmacCases[] = {
 		{true, "F7CF322E6C37E926A73D83C900C21D882BF10BAFCEAFA85C5338DBD8614C34B0", hexBytes("0B0B0B0B0B0B0B0B0B0B0B0B0B0B0B0B0B0B0B0B"), asciiBytes("Hi There")},
@@ -223,6 +418,11 @@ int main(int argc, char **argv) {
 		HmacCase &tc = hmacCases[i];
 		const Sha256Hash actualHash(Sha256::getHmac(tc.key.data(), tc.key.size(), tc.message.data(), tc.message.size()));
 		assert((actualHash == Sha256Hash(tc.expectedHash)) == tc.matches);
+		const HmacSha256Key key(tc.key.data(), tc.key.size());
+		for (int j = 0; j < 2; j++) {  // Key contexts are reusable
+			const Sha256Hash keyedHash(Sha256::getHmac(key, tc.message.data(), tc.message.size()));
+			assert((keyedHash == Sha256Hash(tc.expectedHash)) == tc.matches);
+		}
 		numTestCases++;
 	}
 	
@@ -234,6 +434,89 @@ int main(int argc, char **argv) {
 	{ Sha256 h;  ap(h, "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq");              assert(h.getHash() == Sha256Hash("C106DB19D4EDECF66721FF6459E43CA339603E0C9326C0E5B83806D2616A8D24")); numTestCases++; }
 	{ Sha256 h;  ap(h, "abcdbcdecdefde");  ap(h, "fgefghfghighijhijkijkljklmklmnlmnomnopnopq");  assert(h.getHash() == Sha256Hash("C106DB19D4EDECF66721FF6459E43CA339603E0C9326C0E5B83806D2616A8D24")); numTestCases++; }
 	
+	// BIP340 tagged hashes, with precomputed and computed tag midstates
+	{
+		const Bytes abc(asciiBytes("abc"));
+		Bytes counting(100);
+		for (size_t i = 0; i < counting.size(); i++)
+			counting[i] = static_cast<uint8_t>(i);
+		assert(Sha256::getTaggedHash("TapLeaf", nullptr, 0) == Sha256Hash("CBFA0621DF37662CA57697E5847B6ABAF92934A1A5624916F8D177A388C21252"));
+		assert(Sha256::getTaggedHash("BIP0340/challenge", abc.data(), abc.size()) == Sha256Hash("8700B5FBEBE2943B0CDB18F42E3104D41D95FF437310EAC3BC4B307C7E5B0A77"));
+		assert(Sha256::getTaggedHash("TapTweak", counting.data(), counting.size()) == Sha256Hash("5315117EB4F726E53B6439FE08064BA254AAC49A572F7DA1CAFE8C3A2551E460"));
+		assert(Sha256::getTaggedHash("Custom tag", abc.data(), abc.size()) == Sha256Hash("236AEC2755B3B2BA666D2FA7A4848BF9D84EFAA9B580573FEF563E348D954810"));
+		assert(Sha256::getTaggedHash("", nullptr, 0) == Sha256Hash("35AA66F08D1188251192B73D31E21E7B1B9C83AF3F68A2AE16739E33BC5DBA2D"));
+		numTestCases++;
+		
+		// Every precomputed midstate must equal the computed one
+		const char *tags[] = {"BIP0340/aux", "BIP0340/challenge", "BIP0340/nonce", "TapBranch", "TapLeaf", "TapSighash", "TapTweak", "Custom tag"};
+		for (unsigned int i = 0; i < ARRAY_LENGTH(tags); i++) {
+			const Sha256Hash tagHash(Sha256::getHash(reinterpret_cast<const uint8_t*>(tags[i]), strlen(tags[i])));
+			Sha256 expect;
+			expect.append(tagHash.value, SHA256_HASH_LEN);
+			expect.append(tagHash.value, SHA256_HASH_LEN);
+			expect.append(abc.data(), abc.size());
+			uint32_t midstate[8];
+			Sha256::getTaggedMidstate(tags[i], midstate);
+			Sha256 resumed(midstate, SHA256_BLOCK_LEN);
+			resumed.append(abc.data(), abc.size());
+			assert(resumed.getHash() == expect.getHash());
+			assert(Sha256::getTaggedHash(tags[i], abc.data(), abc.size()) == expect.getHash());
+			numTestCases++;
+		}
+	}
+	
+	// Appending in pieces of every size up to beyond two blocks
+	{
+		Bytes msg(300);
+		for (size_t i = 0; i < msg.size(); i++)
+			msg[i] = static_cast<uint8_t>(i * 11 + 5);
+		for (size_t pieceLen = 1; pieceLen <= 130; pieceLen++) {
+			Sha256 h;
+			for (size_t i = 0; i < msg.size(); i += pieceLen)
+				h.append(&msg[i], i + pieceLen <= msg.size() ? pieceLen : msg.size() - i);
+			assert(h.getHash() == Sha256::getHash(msg.data(), msg.size()));
+		}
+		numTestCases++;
+	}
+	
+	// Non-destructive getHash(), copies as snapshots, and exported midstates
+	{
+		Sha256 h;
+		ap(h, "ab");
+		assert(h.getHash() == Sha256Hash("0306625550B803594D8B7B97BB987234C1F352D69BC3608C243F4C2EFC208EFB"));
+		ap(h, "c");
+		assert(h.getHash() == Sha256Hash("AD1500F261FF10B49C7A1796A36103B02322AE5DDE404141EACF018FBF1678BA"));
+		assert(h.getHash() == Sha256Hash("AD1500F261FF10B49C7A1796A36103B02322AE5DDE404141EACF018FBF1678BA"));
+		numTestCases++;
+	}
+	{
+		uint32_t midstate[8];
+		uint64_t length = 1;
+		Sha256 prefix;
+		ap(prefix, "abcdbcdecdefdefgefghfghighijhijkijkl");
+		assert(!prefix.getMidstate(midstate, length) && length == 1);
+		Sha256 copy(prefix);
+		ap(copy, "jklmklmnlmnomnopnopq");
+		assert(copy.getHash() == Sha256Hash("C106DB19D4EDECF66721FF6459E43CA339603E0C9326C0E5B83806D2616A8D24"));
+		numTestCases++;
+	}
+	for (size_t prefixLen = 0; prefixLen <= 128; prefixLen += SHA256_BLOCK_LEN) {
+		Bytes msg(200);
+		for (size_t i = 0; i < msg.size(); i++)
+			msg[i] = static_cast<uint8_t>(i * 7 + 1);
+		Sha256 prefix;
+		prefix.append(msg.data(), prefixLen);
+		uint32_t midstate[8];
+		uint64_t length;
+		assert(prefix.getMidstate(midstate, length) && length == prefixLen);
+		for (size_t suffixLen = 0; prefixLen + suffixLen <= msg.size(); suffixLen += 9) {
+			Sha256 resumed(midstate, length);
+			resumed.append(&msg[prefixLen], suffixLen);
+			assert(resumed.getHash() == Sha256::getHash(msg.data(), prefixLen + suffixLen));
+		}
+		numTestCases++;
+	}
+	
 	// Epilog
 	printf("All %d test cases passed\n", numTestCases);
 	return 0;
@@ -8,39 +8,262 @@
 
 #include <cassert>
 #include <cstring>
+#include <vector>
 #include "Sha512.hpp"
 #include "Utils.hpp"
 
-#define BLOCK_LEN 128
-
 
 static uint64_t rotr64(uint64_t x, uint64_t i);
 
 
+HmacSha512Key::HmacSha512Key(const uint8_t *key, size_t keyLen) {
+	assert(key != nullptr || keyLen == 0);
+	
+	// Preprocess key
+	uint8_t tempKey[SHA512_BLOCK_LEN] = {};
+	if (keyLen <= SHA512_BLOCK_LEN)
+		Utils::copyBytes(tempKey, key, keyLen);
+	else
+		Sha512::getHash(key, keyLen, tempKey);
+	
+	// Compress inner key block
+	for (int i = 0; i < SHA512_BLOCK_LEN; i++)
+		tempKey[i] ^= 0x36;
+	memcpy(innerState, Sha512::INITIAL_STATE, sizeof(innerState));
+	Sha512::compress(innerState, tempKey, SHA512_BLOCK_LEN);
+	
+	// Compress outer key block
+	for (int i = 0; i < SHA512_BLOCK_LEN; i++)
+		tempKey[i] ^= 0x36 ^ 0x5C;
+	memcpy(outerState, Sha512::INITIAL_STATE, sizeof(outerState));
+	Sha512::compress(outerState, tempKey, SHA512_BLOCK_LEN);
+}
+
+
 void Sha512::getHash(const uint8_t *msg, size_t len, uint8_t hashResult[SHA512_HASH_LEN]) {
+	getHash(msg, len, INITIAL_STATE, 0, hashResult);
+}
+
+
+void Sha512::getHmac(const uint8_t *key, size_t keyLen, const uint8_t *msg, size_t msgLen, uint8_t result[SHA512_HASH_LEN]) {
+	assert((key != nullptr || keyLen == 0) && (msg != nullptr || msgLen == 0) && result != nullptr);
+	getHmac(HmacSha512Key(key, keyLen), msg, msgLen, result);
+}
+
+
+void Sha512::getHmac(const HmacSha512Key &key, const uint8_t *msg, size_t msgLen, uint8_t result[SHA512_HASH_LEN]) {
+	assert((msg != nullptr || msgLen == 0) && result != nullptr);
+	uint8_t innerHash[SHA512_HASH_LEN];
+	getHash(msg, msgLen, key.innerState, SHA512_BLOCK_LEN, innerHash);
+	getHash(innerHash, SHA512_HASH_LEN, key.outerState, SHA512_BLOCK_LEN, result);
+}
+
+
+void Sha512::getHmacMulti(const HmacSha512Key &key, const uint8_t *const msgs[], size_t msgLen,
+		size_t len, uint8_t *const out[]) {
+	assert(((msgs != nullptr && out != nullptr) || len == 0) && msgLen + 17 <= SHA512_BLOCK_LEN);
+	const size_t CHUNK = 16;
+	uint64_t states[CHUNK][8];
+	uint8_t blocks[CHUNK][SHA512_BLOCK_LEN];
+	uint64_t *statePtrs[CHUNK];
+	const uint8_t *blockPtrs[CHUNK];
+	for (size_t i = 0; i < len; i += CHUNK) {
+		size_t n = len - i < CHUNK ? len - i : CHUNK;
+		
+		// Inner hashes: each message and its padding after the inner key block
+		for (size_t j = 0; j < n; j++) {
+			assert((msgs[i + j] != nullptr || msgLen == 0) && out[i + j] != nullptr);
+			memcpy(states[j], key.innerState, sizeof(states[j]));
+			memset(blocks[j], 0, sizeof(blocks[j]));
+			Utils::copyBytes(blocks[j], msgs[i + j], msgLen);
+			blocks[j][msgLen] = 0x80;
+			uint64_t bitLength = static_cast<uint64_t>(SHA512_BLOCK_LEN + msgLen) << 3;
+			for (int k = 1; k <= 8; k++, bitLength >>= 8)
+				blocks[j][SHA512_BLOCK_LEN - k] = static_cast<uint8_t>(bitLength);
+			statePtrs[j] = states[j];
+			blockPtrs[j] = blocks[j];
+		}
+		compressMulti(statePtrs, blockPtrs, n);
+		
+		// Outer hashes: each inner hash and its padding after the outer key block
+		for (size_t j = 0; j < n; j++) {
+			memset(blocks[j], 0, sizeof(blocks[j]));
+			for (int k = 0; k < SHA512_HASH_LEN; k++)
+				blocks[j][k] = static_cast<uint8_t>(states[j][k >> 3] >> ((7 - (k & 7)) << 3));
+			blocks[j][SHA512_HASH_LEN] = 0x80;
+			uint64_t bitLength = static_cast<uint64_t>(SHA512_BLOCK_LEN + SHA512_HASH_LEN) << 3;
+			for (int k = 1; k <= 8; k++, bitLength >>= 8)
+				blocks[j][SHA512_BLOCK_LEN - k] = static_cast<uint8_t>(bitLength);
+			memcpy(states[j], key.outerState, sizeof(states[j]));
+		}
+		compressMulti(statePtrs, blockPtrs, n);
+		
+		// Uint64 arrays to bytes in big endian
+		for (size_t j = 0; j < n; j++) {
+			for (int k = 0; k < SHA512_HASH_LEN; k++)
+				out[i + j][k] = static_cast<uint8_t>(states[j][k >> 3] >> ((7 - (k & 7)) << 3));
+		}
+	}
+}
+
+
+void Sha512::getHashMulti(const uint8_t *const msgs[], const size_t lens[], size_t len, uint8_t *const out[]) {
+	assert((msgs != nullptr && lens != nullptr && out != nullptr) || len == 0);
+	const size_t CHUNK = 16;
+	uint64_t states[CHUNK][8];
+	uint8_t tails[CHUNK][SHA512_BLOCK_LEN * 2];  // Final partial block, padding, and length
+	size_t fullBlocks[CHUNK];
+	size_t totalBlocks[CHUNK];
+	for (size_t i = 0; i < len; i += CHUNK) {
+		size_t n = len - i < CHUNK ? len - i : CHUNK;
+		size_t maxBlocks = 0;
+		for (size_t j = 0; j < n; j++) {
+			const uint8_t *msg = msgs[i + j];
+			size_t msgLen = lens[i + j];
+			assert((msg != nullptr || msgLen == 0) && out[i + j] != nullptr);
+			memcpy(states[j], INITIAL_STATE, sizeof(INITIAL_STATE));
+			fullBlocks[j] = msgLen / SHA512_BLOCK_LEN;
+			totalBlocks[j] = (msgLen + 16) / SHA512_BLOCK_LEN + 1;
+			if (totalBlocks[j] > maxBlocks)
+				maxBlocks = totalBlocks[j];
+			
+			uint8_t *tail = tails[j];
+			memset(tail, 0, sizeof(tails[j]));
+			size_t off = fullBlocks[j] * SHA512_BLOCK_LEN;
+			Utils::copyBytes(tail, &msg[off], msgLen - off);
+			tail[msgLen - off] = 0x80;
+			uint64_t bitLength = static_cast<uint64_t>(msgLen) << 3;
+			size_t end = (totalBlocks[j] - fullBlocks[j]) * SHA512_BLOCK_LEN;
+			for (int k = 1; k <= 8; k++, bitLength >>= 8)
+				tail[end - k] = static_cast<uint8_t>(bitLength);
+		}
+		
+		// Each step compresses the next block of every message that still has one
+		for (size_t k = 0; k < maxBlocks; k++) {
+			uint64_t *statePtrs[CHUNK];
+			const uint8_t *blockPtrs[CHUNK];
+			size_t m = 0;
+			for (size_t j = 0; j < n; j++) {
+				if (k >= totalBlocks[j])
+					continue;
+				statePtrs[m] = states[j];
+				if (k < fullBlocks[j])
+					blockPtrs[m] = &msgs[i + j][k * SHA512_BLOCK_LEN];
+				else
+					blockPtrs[m] = &tails[j][(k - fullBlocks[j]) * SHA512_BLOCK_LEN];
+				m++;
+			}
+			compressMulti(statePtrs, blockPtrs, m);
+		}
+		
+		// Uint64 arrays to bytes in big endian
+		for (size_t j = 0; j < n; j++) {
+			for (int k = 0; k < SHA512_HASH_LEN; k++)
+				out[i + j][k] = static_cast<uint8_t>(states[j][k >> 3] >> ((7 - (k & 7)) << 3));
+		}
+	}
+}
+
+
+void Sha512::getPbkdf2(const uint8_t *password, size_t passwordLen, const uint8_t *salt, size_t saltLen,
+		uint32_t iterations, uint8_t *out, size_t outLen) {
+	assert((password != nullptr || passwordLen == 0) && (salt != nullptr || saltLen == 0));
+	assert(iterations > 0 && (out != nullptr || outLen == 0));
+	const HmacSha512Key key(password, passwordLen);
+	for (uint32_t blockIndex = 1; outLen > 0; blockIndex++) {
+		uint64_t words[16];
+		getPbkdf2FirstBlock(key, salt, saltLen, blockIndex, words);
+		memcpy(&words[8], &words[0], sizeof(words) / 2);
+		// A lone password gains nothing from SIMD lanes
+		pbkdf2IterateSerial(&key, words, 1, iterations - 1);
+		
+		// Uint64 array to bytes in big endian
+		size_t n = outLen < SHA512_HASH_LEN ? outLen : SHA512_HASH_LEN;
+		for (size_t i = 0; i < n; i++)
+			out[i] = static_cast<uint8_t>(words[8 + (i >> 3)] >> ((7 - (i & 7)) << 3));
+		out += n;
+		outLen -= n;
+	}
+}
+
+
+void Sha512::getPbkdf2Multi(const uint8_t *const passwords[], const size_t passwordLens[], size_t len,
+		const uint8_t *salt, size_t saltLen, uint32_t iterations, uint8_t *const outs[], size_t outLen) {
+	assert((passwords != nullptr && passwordLens != nullptr && outs != nullptr) || len == 0);
+	assert((salt != nullptr || saltLen == 0) && iterations > 0);
+	static const Pbkdf2IterateFunc func = selectPbkdf2Iterate();  // Thread-safe initialization since C++11
+	
+	std::vector<HmacSha512Key> keys;
+	keys.reserve(len);
+	for (size_t i = 0; i < len; i++)
+		keys.push_back(HmacSha512Key(passwords[i], passwordLens[i]));
+	std::vector<uint64_t> words(len * 16);
+	for (size_t off = 0, blockIndex = 1; off < outLen; off += SHA512_HASH_LEN, blockIndex++) {
+		for (size_t i = 0; i < len; i++) {
+			getPbkdf2FirstBlock(keys[i], salt, saltLen, static_cast<uint32_t>(blockIndex), &words[i * 16]);
+			memcpy(&words[i * 16 + 8], &words[i * 16], 8 * sizeof(uint64_t));
+		}
+		func(keys.data(), words.data(), len, iterations - 1);
+		
+		// Uint64 arrays to bytes in big endian
+		size_t n = outLen - off < SHA512_HASH_LEN ? outLen - off : SHA512_HASH_LEN;
+		for (size_t i = 0; i < len; i++) {
+			for (size_t j = 0; j < n; j++)
+				outs[i][off + j] = static_cast<uint8_t>(words[i * 16 + 8 + (j >> 3)] >> ((7 - (j & 7)) << 3));
+		}
+	}
+}
+
+
+void Sha512::getPbkdf2FirstBlock(const HmacSha512Key &key, const uint8_t *salt, size_t saltLen,
+		uint32_t blockIndex, uint64_t outWords[8]) {
+	Sha512 inner(key.innerState, SHA512_BLOCK_LEN);
+	inner.append(salt, saltLen);
+	const uint8_t indexBytes[4] = {
+		static_cast<uint8_t>(blockIndex >> 24),
+		static_cast<uint8_t>(blockIndex >> 16),
+		static_cast<uint8_t>(blockIndex >>  8),
+		static_cast<uint8_t>(blockIndex >>  0),
+	};
+	inner.append(indexBytes, sizeof(indexBytes));
+	uint8_t hash[SHA512_HASH_LEN];
+	inner.getHash(hash);
+	getHash(hash, SHA512_HASH_LEN, key.outerState, SHA512_BLOCK_LEN, hash);
+	
+	// Bytes to uint64 array in big endian
+	for (int i = 0; i < 8; i++) {
+		uint64_t w = 0;
+		for (int j = 0; j < 8; j++)
+			w = (w << 8) | hash[i * 8 + j];
+		outWords[i] = w;
+	}
+}
+
+
+void Sha512::getHash(const uint8_t *msg, size_t len, const uint64_t initState[8], uint64_t prefixLen, uint8_t hashResult[SHA512_HASH_LEN]) {
 	// Compress whole message blocks
-	assert((msg != nullptr || len == 0) && hashResult != nullptr);
-	uint64_t state[8] = {
-		UINT64_C(0x6A09E667F3BCC908), UINT64_C(0xBB67AE8584CAA73B), UINT64_C(0x3C6EF372FE94F82B), UINT64_C(0xA54FF53A5F1D36F1),
-		UINT64_C(0x510E527FADE682D1), UINT64_C(0x9B05688C2B3E6C1F), UINT64_C(0x1F83D9ABFB41BD6B), UINT64_C(0x5BE0CD19137E2179)};
-	size_t off = len & ~static_cast<size_t>(BLOCK_LEN - 1);
+	assert((msg != nullptr || len == 0) && initState != nullptr && prefixLen % SHA512_BLOCK_LEN == 0 && hashResult != nullptr);
+	uint64_t state[8];
+	memcpy(state, initState, sizeof(state));
+	size_t off = len & ~static_cast<size_t>(SHA512_BLOCK_LEN - 1);
 	compress(state, msg, off);
 	
 	// Final blocks, padding, and length
-	uint8_t block[BLOCK_LEN] = {};
+	uint8_t block[SHA512_BLOCK_LEN] = {};
 	Utils::copyBytes(block, &msg[off], len - off);
-	off = len & (BLOCK_LEN - 1);
+	off = len & (SHA512_BLOCK_LEN - 1);
 	block[off] = 0x80;
 	off++;
-	if (off + 16 > BLOCK_LEN) {
-		compress(state, block, BLOCK_LEN);
-		memset(block, 0, BLOCK_LEN);
-	}
-	block[BLOCK_LEN - 1] = static_cast<uint8_t>((len & 0x1FU) << 3);
-	len >>= 5;
-	for (int i = 1; i < 16; i++, len >>= 8)
-		block[BLOCK_LEN - 1 - i] = static_cast<uint8_t>(len);
-	compress(state, block, BLOCK_LEN);
+	if (off + 16 > SHA512_BLOCK_LEN) {
+		compress(state, block, SHA512_BLOCK_LEN);
+		memset(block, 0, SHA512_BLOCK_LEN);
+	}
+	uint64_t totalLen = prefixLen + len;
+	block[SHA512_BLOCK_LEN - 1] = static_cast<uint8_t>((totalLen & 0x1FU) << 3);
+	totalLen >>= 5;
+	for (int i = 1; i < 16; i++, totalLen >>= 8)
+		block[SHA512_BLOCK_LEN - 1 - i] = static_cast<uint8_t>(totalLen);
+	compress(state, block, SHA512_BLOCK_LEN);
 	
 	// Uint64 array to bytes in big endian
 	for (int i = 0; i < SHA512_HASH_LEN; i++)
@@ -49,7 +272,56 @@ void Sha512::getHash(const uint8_t *msg, size_t len, uint8_t hashResult[SHA512_H
 
 
 void Sha512::compress(uint64_t state[8], const uint8_t *blocks, size_t len) {
-	assert(len % BLOCK_LEN == 0);
+	assert(state != nullptr && (blocks != nullptr || len == 0));
+	assert(len % SHA512_BLOCK_LEN == 0);
+	static const CompressFunc func = selectCompress();  // Thread-safe initialization since C++11
+	func(state, blocks, len);
+}
+
+
+Sha512::CompressFunc Sha512::selectCompress() {
+#ifdef USE_X86_INTRINSICS
+	if (Utils::getCpuFeatures().avx2)
+		return compressAvx2;
+#endif
+	return compressPortable;
+}
+
+
+// Runs the 80 rounds on the given state with a fully expanded message schedule.
+static INLINE_LANES void compressRounds(uint64_t state[8], const uint64_t schedule[80], const uint64_t roundConstants[80]) {
+	uint64_t a = state[0];
+	uint64_t b = state[1];
+	uint64_t c = state[2];
+	uint64_t d = state[3];
+	uint64_t e = state[4];
+	uint64_t f = state[5];
+	uint64_t g = state[6];
+	uint64_t h = state[7];
+	for (int j = 0; j < 80; j++) {
+		uint64_t t1 = 0U + h + (rotr64(e, 14) ^ rotr64(e, 18) ^ rotr64(e, 41)) + (g ^ (e & (f ^ g))) + roundConstants[j] + schedule[j];
+		uint64_t t2 = 0U + (rotr64(a, 28) ^ rotr64(a, 34) ^ rotr64(a, 39)) + ((a & (b | c)) | (b & c));
+		h = g;
+		g = f;
+		f = e;
+		e = 0U + d + t1;
+		d = c;
+		c = b;
+		b = a;
+		a = 0U + t1 + t2;
+	}
+	state[0] = 0U + state[0] + a;
+	state[1] = 0U + state[1] + b;
+	state[2] = 0U + state[2] + c;
+	state[3] = 0U + state[3] + d;
+	state[4] = 0U + state[4] + e;
+	state[5] = 0U + state[5] + f;
+	state[6] = 0U + state[6] + g;
+	state[7] = 0U + state[7] + h;
+}
+
+
+void Sha512::compressPortable(uint64_t state[8], const uint8_t *blocks, size_t len) {
 	uint64_t schedule[80];
 	for (size_t i = 0; i < len; ) {
 		
@@ -71,46 +343,367 @@ void Sha512::compress(uint64_t state[8], const uint8_t *blocks, size_t len) {
 				+ (rotr64(schedule[j -  2], 19) ^ rotr64(schedule[j -  2], 61) ^ (schedule[j -  2] >> 6));
 		}
 		
-		// The 80 rounds
-		uint64_t a = state[0];
-		uint64_t b = state[1];
-		uint64_t c = state[2];
-		uint64_t d = state[3];
-		uint64_t e = state[4];
-		uint64_t f = state[5];
-		uint64_t g = state[6];
-		uint64_t h = state[7];
-		for (int j = 0; j < 80; j++) {
-			uint64_t t1 = 0U + h + (rotr64(e, 14) ^ rotr64(e, 18) ^ rotr64(e, 41)) + (g ^ (e & (f ^ g))) + ROUND_CONSTANTS[j] + schedule[j];
-			uint64_t t2 = 0U + (rotr64(a, 28) ^ rotr64(a, 34) ^ rotr64(a, 39)) + ((a & (b | c)) | (b & c));
-			h = g;
-			g = f;
-			f = e;
-			e = 0U + d + t1;
-			d = c;
-			c = b;
-			b = a;
-			a = 0U + t1 + t2;
+		compressRounds(state, schedule, ROUND_CONSTANTS);
+	}
+}
+
+
+// Rotates every 64-bit element of the vector (or a plain uint64_t) right. Requires 1 <= i <= 63.
+#define ROTR_LANES(x, i)  (((x) >> (i)) | ((x) << (64 - (i))))
+
+
+// Runs the 80 rounds on the given state vectors and adds the result into them, where element k of every
+// vector belongs to the k-th lane. The schedule ring is expanded in place from its 16 initial words.
+// Vec can also be plain uint64_t for a single lane.
+template <typename Vec>
+static INLINE_LANES void roundsLanes(Vec state[8], Vec schedule[16], const uint64_t roundConstants[80]) {
+	Vec a = state[0];
+	Vec b = state[1];
+	Vec c = state[2];
+	Vec d = state[3];
+	Vec e = state[4];
+	Vec f = state[5];
+	Vec g = state[6];
+	Vec h = state[7];
+	for (int j = 0; j < 80; j++) {
+		if (j >= 16) {
+			Vec w15 = schedule[(j - 15) & 15];
+			Vec w2 = schedule[(j - 2) & 15];
+			schedule[j & 15] += schedule[(j - 7) & 15]
+				+ (ROTR_LANES(w15,  1) ^ ROTR_LANES(w15,  8) ^ (w15 >> 7))
+				+ (ROTR_LANES(w2 , 19) ^ ROTR_LANES(w2 , 61) ^ (w2  >> 6));
 		}
-		state[0] = 0U + state[0] + a;
-		state[1] = 0U + state[1] + b;
-		state[2] = 0U + state[2] + c;
-		state[3] = 0U + state[3] + d;
-		state[4] = 0U + state[4] + e;
-		state[5] = 0U + state[5] + f;
-		state[6] = 0U + state[6] + g;
-		state[7] = 0U + state[7] + h;
+		Vec t1 = h + (ROTR_LANES(e, 14) ^ ROTR_LANES(e, 18) ^ ROTR_LANES(e, 41)) + (g ^ (e & (f ^ g)))
+			+ roundConstants[j] + schedule[j & 15];
+		Vec t2 = (ROTR_LANES(a, 28) ^ ROTR_LANES(a, 34) ^ ROTR_LANES(a, 39)) + ((a & (b | c)) | (b & c));
+		h = g;
+		g = f;
+		f = e;
+		e = d + t1;
+		d = c;
+		c = b;
+		b = a;
+		a = t1 + t2;
 	}
+	state[0] += a;
+	state[1] += b;
+	state[2] += c;
+	state[3] += d;
+	state[4] += e;
+	state[5] += f;
+	state[6] += g;
+	state[7] += h;
 }
 
 
-Sha512::Sha512() {}
+// Runs the given number of PBKDF2 iterations on one group of lanes. Each iteration hashes the previous
+// 64-byte output u under the inner and outer HMAC states, as words with the fixed padding of a message
+// that follows one key block, and accumulates the result into t. No bytes are serialized in between.
+template <typename Vec>
+static INLINE_LANES void pbkdf2IterateLanes(const Vec inner[8], const Vec outer[8],
+		Vec u[8], Vec t[8], uint32_t iterations, const uint64_t roundConstants[80]) {
+	const Vec zero = {};
+	for (uint32_t i = 0; i < iterations; i++) {
+		Vec state[8];
+		Vec schedule[16];
+		for (int j = 0; j < 8; j++) {
+			schedule[j] = u[j];
+			state[j] = inner[j];
+		}
+		schedule[8] = zero + UINT64_C(0x8000000000000000);
+		for (int j = 9; j < 15; j++)
+			schedule[j] = zero;
+		schedule[15] = zero + UINT64_C((SHA512_BLOCK_LEN + SHA512_HASH_LEN) * 8);
+		roundsLanes<Vec>(state, schedule, roundConstants);
+		
+		for (int j = 0; j < 8; j++) {
+			schedule[j] = state[j];
+			state[j] = outer[j];
+		}
+		schedule[8] = zero + UINT64_C(0x8000000000000000);
+		for (int j = 9; j < 15; j++)
+			schedule[j] = zero;
+		schedule[15] = zero + UINT64_C((SHA512_BLOCK_LEN + SHA512_HASH_LEN) * 8);
+		roundsLanes<Vec>(state, schedule, roundConstants);
+		
+		for (int j = 0; j < 8; j++) {
+			u[j] = state[j];
+			t[j] ^= state[j];
+		}
+	}
+}
 
 
-#undef BLOCK_LEN
+void Sha512::compressMulti(uint64_t *const states[], const uint8_t *const blocks[], size_t len) {
+	assert((states != nullptr && blocks != nullptr) || len == 0);
+	static const CompressMultiFunc func = selectCompressMulti();  // Thread-safe initialization since C++11
+	func(states, blocks, len);
+}
+
+
+Sha512::CompressMultiFunc Sha512::selectCompressMulti() {
+#ifdef USE_X86_INTRINSICS
+	const Utils::CpuFeatures &cpu = Utils::getCpuFeatures();
+	if (cpu.avx512f)
+		return compressMultiAvx512;
+	if (cpu.avx2)
+		return compressMultiAvx2;
+#endif
+	return compressMultiSerial;
+}
+
+
+void Sha512::compressMultiSerial(uint64_t *const states[], const uint8_t *const blocks[], size_t len) {
+	for (size_t i = 0; i < len; i++)
+		compress(states[i], blocks[i], SHA512_BLOCK_LEN);
+}
+
+
+Sha512::Pbkdf2IterateFunc Sha512::selectPbkdf2Iterate() {
+#ifdef USE_X86_INTRINSICS
+	const Utils::CpuFeatures &cpu = Utils::getCpuFeatures();
+	if (cpu.avx512f)
+		return pbkdf2IterateAvx512;
+	if (cpu.avx2)
+		return pbkdf2IterateAvx2;
+#endif
+	return pbkdf2IterateSerial;
+}
+
+
+void Sha512::pbkdf2IterateSerial(const HmacSha512Key keys[], uint64_t words[], size_t len, uint32_t iterations) {
+	for (size_t i = 0; i < len; i++) {
+		uint64_t *w = &words[i * 16];
+		pbkdf2IterateLanes<uint64_t>(keys[i].innerState, keys[i].outerState, &w[0], &w[8], iterations, ROUND_CONSTANTS);
+	}
+}
+
+
+#ifdef USE_X86_INTRINSICS
+
+typedef uint64_t Uint64x2 __attribute__((vector_size(16)));
+typedef uint64_t Uint64x4 __attribute__((vector_size(32)));
+typedef uint64_t Uint64x8 __attribute__((vector_size(64)));
+
+
+// Loads 16 big-endian words from each lane's block into transposed schedule vectors.
+template <typename Vec, int LANES>
+static INLINE_LANES void loadScheduleLanes(Vec schedule[16], const uint8_t *const blocks[LANES]) {
+	for (int j = 0; j < 16; j++) {
+		for (int k = 0; k < LANES; k++) {
+			const uint8_t *b = &blocks[k][j * 8];
+			uint64_t w = 0;
+			for (int m = 0; m < 8; m++)
+				w = (w << 8) | b[m];
+			schedule[j][k] = w;
+		}
+	}
+}
+
+
+// Compresses one block into each of the given states, LANES at a time. A final partial group is padded with dummy lanes.
+template <typename Vec, int LANES>
+static INLINE_LANES void compressLanes(
+		uint64_t *const states[], const uint8_t *const blocks[], size_t len, const uint64_t roundConstants[80]) {
+	uint64_t dummyState[8] = {};
+	const uint8_t dummyBlock[SHA512_BLOCK_LEN] = {};
+	for (size_t i = 0; i < len; i += LANES) {
+		uint64_t *laneStates[LANES];
+		const uint8_t *laneBlocks[LANES];
+		for (int k = 0; k < LANES; k++) {
+			bool active = i + k < len;
+			laneStates[k] = active ? states[i + k] : dummyState;
+			laneBlocks[k] = active ? blocks[i + k] : dummyBlock;
+		}
+		
+		Vec state[8];
+		Vec schedule[16];
+		for (int j = 0; j < 8; j++) {
+			for (int k = 0; k < LANES; k++)
+				state[j][k] = laneStates[k][j];
+		}
+		loadScheduleLanes<Vec, LANES>(schedule, laneBlocks);
+		roundsLanes<Vec>(state, schedule, roundConstants);
+		for (int j = 0; j < 8; j++) {
+			for (int k = 0; k < LANES; k++)
+				laneStates[k][j] = state[j][k];
+		}
+	}
+}
+
+
+// Runs the PBKDF2 iterations for whole groups of LANES passwords, and returns the number of passwords processed.
+template <typename Vec, int LANES>
+static INLINE_LANES size_t pbkdf2IterateGroups(const HmacSha512Key keys[], uint64_t words[],
+		size_t len, uint32_t iterations, const uint64_t roundConstants[80]) {
+	size_t i = 0;
+	for (; i + LANES <= len; i += LANES) {
+		Vec inner[8], outer[8], u[8], t[8];
+		for (int j = 0; j < 8; j++) {
+			for (int k = 0; k < LANES; k++) {
+				inner[j][k] = keys[i + k].innerState[j];
+				outer[j][k] = keys[i + k].outerState[j];
+				u[j][k] = words[(i + k) * 16 + j];
+				t[j][k] = words[(i + k) * 16 + 8 + j];
+			}
+		}
+		pbkdf2IterateLanes<Vec>(inner, outer, u, t, iterations, roundConstants);
+		for (int j = 0; j < 8; j++) {
+			for (int k = 0; k < LANES; k++) {
+				words[(i + k) * 16 + j] = u[j][k];
+				words[(i + k) * 16 + 8 + j] = t[j][k];
+			}
+		}
+	}
+	return i;
+}
+
+
+// Like compressPortable(), but expands the message schedule two words per step in vector registers,
+// because each word depends on the word two positions back. Pairs may start at unaligned offsets.
+__attribute__((target("avx2")))
+void Sha512::compressAvx2(uint64_t state[8], const uint8_t *blocks, size_t len) {
+	uint64_t schedule[80];
+	for (size_t i = 0; i < len; i += SHA512_BLOCK_LEN) {
+		for (int j = 0; j < 16; j++) {
+			const uint8_t *b = &blocks[i + j * 8];
+			schedule[j] = static_cast<uint64_t>(b[0]) << 56
+			            | static_cast<uint64_t>(b[1]) << 48
+			            | static_cast<uint64_t>(b[2]) << 40
+			            | static_cast<uint64_t>(b[3]) << 32
+			            | static_cast<uint64_t>(b[4]) << 24
+			            | static_cast<uint64_t>(b[5]) << 16
+			            | static_cast<uint64_t>(b[6]) <<  8
+			            | static_cast<uint64_t>(b[7]) <<  0;
+		}
+		for (int j = 16; j < 80; j += 2) {
+			Uint64x2 w16, w15, w7, w2;
+			memcpy(&w16, &schedule[j - 16], sizeof(w16));
+			memcpy(&w15, &schedule[j - 15], sizeof(w15));
+			memcpy(&w7 , &schedule[j -  7], sizeof(w7 ));
+			memcpy(&w2 , &schedule[j -  2], sizeof(w2 ));
+			Uint64x2 w = w16 + w7
+				+ (ROTR_LANES(w15,  1) ^ ROTR_LANES(w15,  8) ^ (w15 >> 7))
+				+ (ROTR_LANES(w2 , 19) ^ ROTR_LANES(w2 , 61) ^ (w2  >> 6));
+			memcpy(&schedule[j], &w, sizeof(w));
+		}
+		compressRounds(state, schedule, ROUND_CONSTANTS);
+	}
+}
+
+
+__attribute__((target("avx2")))
+void Sha512::compressMultiAvx2(uint64_t *const states[], const uint8_t *const blocks[], size_t len) {
+	compressLanes<Uint64x4, 4>(states, blocks, len, ROUND_CONSTANTS);
+}
+
+
+__attribute__((target("avx512f")))
+void Sha512::compressMultiAvx512(uint64_t *const states[], const uint8_t *const blocks[], size_t len) {
+	compressLanes<Uint64x8, 8>(states, blocks, len, ROUND_CONSTANTS);
+}
+
+
+__attribute__((target("avx2")))
+void Sha512::pbkdf2IterateAvx2(const HmacSha512Key keys[], uint64_t words[], size_t len, uint32_t iterations) {
+	size_t i = pbkdf2IterateGroups<Uint64x4, 4>(keys, words, len, iterations, ROUND_CONSTANTS);
+	pbkdf2IterateSerial(&keys[i], &words[i * 16], len - i, iterations);
+}
+
+
+__attribute__((target("avx512f")))
+void Sha512::pbkdf2IterateAvx512(const HmacSha512Key keys[], uint64_t words[], size_t len, uint32_t iterations) {
+	size_t i = pbkdf2IterateGroups<Uint64x8, 8>(keys, words, len, iterations, ROUND_CONSTANTS);
+	i += pbkdf2IterateGroups<Uint64x4, 4>(&keys[i], &words[i * 16], len - i, iterations, ROUND_CONSTANTS);
+	pbkdf2IterateSerial(&keys[i], &words[i * 16], len - i, iterations);
+}
+
+#endif
+
+#undef ROTR_LANES
+
+
+Sha512::Sha512() :
+		length(0),
+		buffer(),
+		bufferLen(0) {
+	memcpy(state, INITIAL_STATE, sizeof(state));
+}
+
+
+Sha512::Sha512(const uint64_t midstate[8], uint64_t length_) :
+		length(length_),
+		buffer(),
+		bufferLen(0) {
+	assert(midstate != nullptr && length_ % SHA512_BLOCK_LEN == 0);
+	memcpy(state, midstate, sizeof(state));
+}
+
+
+void Sha512::append(const uint8_t *bytes, size_t len) {
+	assert(bytes != nullptr || len == 0);
+	length += len;
+	
+	// Top up a partially filled buffer
+	if (bufferLen > 0) {
+		size_t n = SHA512_BLOCK_LEN - static_cast<size_t>(bufferLen);
+		if (n > len)
+			n = len;
+		Utils::copyBytes(&buffer[bufferLen], bytes, n);
+		bufferLen += static_cast<int>(n);
+		bytes += n;
+		len -= n;
+		if (bufferLen < SHA512_BLOCK_LEN)
+			return;
+		compress(state, buffer, SHA512_BLOCK_LEN);
+		bufferLen = 0;
+	}
+	
+	// Compress whole blocks straight from the input, and buffer the rest
+	size_t wholeLen = len & ~static_cast<size_t>(SHA512_BLOCK_LEN - 1);
+	compress(state, bytes, wholeLen);
+	Utils::copyBytes(buffer, bytes + wholeLen, len - wholeLen);
+	bufferLen = static_cast<int>(len - wholeLen);
+}
+
+
+bool Sha512::getMidstate(uint64_t outState[8], uint64_t &outLength) const {
+	assert(outState != nullptr);
+	if (bufferLen != 0)
+		return false;
+	memcpy(outState, state, sizeof(state));
+	outLength = length;
+	return true;
+}
+
+
+void Sha512::getHash(uint8_t hashResult[SHA512_HASH_LEN]) const {
+	assert(hashResult != nullptr);
+	
+	// Pad the buffered bytes into one or two final blocks, compressed into a copy of the state
+	uint64_t tempState[8];
+	memcpy(tempState, state, sizeof(tempState));
+	uint8_t blocks[SHA512_BLOCK_LEN * 2] = {};
+	memcpy(blocks, buffer, static_cast<size_t>(bufferLen));
+	blocks[bufferLen] = 0x80;
+	size_t blocksLen = bufferLen + 17 <= SHA512_BLOCK_LEN ? SHA512_BLOCK_LEN : SHA512_BLOCK_LEN * 2;
+	uint64_t bitLength = length << 3;
+	for (int i = 1; i <= 8; i++, bitLength >>= 8)
+		blocks[blocksLen - i] = static_cast<uint8_t>(bitLength);
+	blocks[blocksLen - 9] = static_cast<uint8_t>(length >> 61);
+	compress(tempState, blocks, blocksLen);
+	
+	// Uint64 array to bytes in big endian
+	for (int i = 0; i < SHA512_HASH_LEN; i++)
+		hashResult[i] = static_cast<uint8_t>(tempState[i >> 3] >> ((7 - (i & 7)) << 3));
+}
 
 
 // Static initializers
+const uint64_t Sha512::INITIAL_STATE[8] = {
+	UINT64_C(0x6A09E667F3BCC908), UINT64_C(0xBB67AE8584CAA73B), UINT64_C(0x3C6EF372FE94F82B), UINT64_C(0xA54FF53A5F1D36F1),
+	UINT64_C(0x510E527FADE682D1), UINT64_C(0x9B05688C2B3E6C1F), UINT64_C(0x1F83D9ABFB41BD6B), UINT64_C(0x5BE0CD19137E2179),
+};
 const uint64_t Sha512::ROUND_CONSTANTS[80] = {
 	UINT64_C(0x428A2F98D728AE22), UINT64_C(0x7137449123EF65CD), UINT64_C(0xB5C0FBCFEC4D3B2F), UINT64_C(0xE9B5DBA58189DBBC),
 	UINT64_C(0x3956C25BF348B538), UINT64_C(0x59F111F1B605D019), UINT64_C(0x923F82A4AF194F9B), UINT64_C(0xAB1C5ED5DA6D8118),
@@ -12,11 +12,29 @@
 #include <cstdint>
 
 
+/* 
+ * The HMAC-SHA-512 states for one key, after compressing its inner and outer padded key blocks.
+ * A key context can be passed to Sha512::getHmac() any number of times to avoid rekeying,
+ * which suits BIP32 derivation where one chain code keys many messages.
+ */
+struct HmacSha512Key final {
+	
+	uint64_t innerState[8];
+	uint64_t outerState[8];
+	
+	
+	HmacSha512Key(const uint8_t *key, size_t keyLen);
+	
+};
+
+
+
 /* 
  * Computes the SHA-512 hash of a sequence of bytes. The hash value is 64 bytes long.
- * Provides just one static method.
+ * Provides a static method, and an instantiable stateful hasher.
  */
 #define SHA512_HASH_LEN 64
+#define SHA512_BLOCK_LEN 128
 class Sha512 final {
 	
 	/*---- Static functions ----*/
@@ -25,15 +43,149 @@ public:
 	static void getHash(const uint8_t *msg, size_t len, uint8_t hashResult[SHA512_HASH_LEN]);
 	
 	
+	static void getHmac(const uint8_t *key, size_t keyLen, const uint8_t *msg, size_t msgLen, uint8_t result[SHA512_HASH_LEN]);
+	
+	
+	// Computes the HMAC of the given message with the given precomputed key context. For messages up
+	// to 111 bytes (such as BIP32's 37-byte data), this costs just one inner and one outer compression.
+	static void getHmac(const HmacSha512Key &key, const uint8_t *msg, size_t msgLen, uint8_t result[SHA512_HASH_LEN]);
+	
+	
+	// Computes the HMACs of the given number of independent messages under one key context, such that out[i] receives
+	// the same 64 bytes as getHmac(key, msgs[i], msgLen, out[i]). Every message has the same length, which must be
+	// at most 111 bytes so that each inner and outer hash is a single block step through compressMulti().
+	static void getHmacMulti(const HmacSha512Key &key, const uint8_t *const msgs[], size_t msgLen,
+		size_t len, uint8_t *const out[]);
+	
+	
+	// Computes the hashes of the given number of independent messages, such that out[i] receives the same 64 bytes
+	// as getHash(msgs[i], lens[i], out[i]). The messages may have different lengths, but throughput is best when
+	// the lengths are similar. Every block step goes through compressMulti().
+	static void getHashMulti(const uint8_t *const msgs[], const size_t lens[], size_t len, uint8_t *const out[]);
+	
+	
+	// Derives outLen bytes from the given password and salt using PBKDF2 with HMAC-SHA-512, as in RFC 8018.
+	// The iteration count must be positive. For example, BIP39 uses 2048 iterations, a salt of "mnemonic"
+	// followed by the passphrase, and an output length of 64 bytes.
+	static void getPbkdf2(const uint8_t *password, size_t passwordLen, const uint8_t *salt, size_t saltLen,
+		uint32_t iterations, uint8_t *out, size_t outLen);
+	
+	
+	// Derives keys for the given number of independent passwords that share one salt and iteration count,
+	// such that outs[i] gets the same outLen bytes as getPbkdf2(passwords[i], passwordLens[i], ...).
+	// Processes 8 (AVX-512) or 4 (AVX2) passwords in parallel SIMD lanes if the CPU supports them.
+	static void getPbkdf2Multi(const uint8_t *const passwords[], const size_t passwordLens[], size_t len,
+		const uint8_t *salt, size_t saltLen, uint32_t iterations, uint8_t *const outs[], size_t outLen);
+	
+	
 private:
 	
+	// Computes the hash of a message that follows the given number of prefix bytes already compressed into initState.
+	static void getHash(const uint8_t *msg, size_t len, const uint64_t initState[8], uint64_t prefixLen, uint8_t hashResult[SHA512_HASH_LEN]);
+	
+	// Computes the words of the PBKDF2 block U_1 = HMAC(password, salt || INT(blockIndex)).
+	static void getPbkdf2FirstBlock(const HmacSha512Key &key, const uint8_t *salt, size_t saltLen,
+		uint32_t blockIndex, uint64_t outWords[8]);
+	
+	
+public:
+	// Compresses whole blocks into the given state. Expands the message schedule in vector registers
+	// if the CPU supports AVX2 (detected once), or else uses the portable implementation.
 	static void compress(uint64_t state[8], const uint8_t *blocks, size_t len);
 	
-	Sha512();  // Not instantiable
+	
+private:
+	typedef void (*CompressFunc)(uint64_t state[8], const uint8_t *blocks, size_t len);
+	
+	static CompressFunc selectCompress();
+	
+	static void compressPortable(uint64_t state[8], const uint8_t *blocks, size_t len);
+	
+	// Only defined if USE_X86_INTRINSICS is defined.
+	static void compressAvx2(uint64_t state[8], const uint8_t *blocks, size_t len);
+	
+	
+public:
+	// Compresses exactly one block into each state, such that the effect is equivalent to calling
+	// compress(states[i], blocks[i], SHA512_BLOCK_LEN) for each i. Processes 8 (AVX-512) or 4 (AVX2)
+	// states in parallel SIMD lanes if the CPU supports them, or else calls compress() in a loop.
+	static void compressMulti(uint64_t *const states[], const uint8_t *const blocks[], size_t len);
+	
+	
+private:
+	typedef void (*CompressMultiFunc)(uint64_t *const states[], const uint8_t *const blocks[], size_t len);
+	
+	static CompressMultiFunc selectCompressMulti();
+	
+	static void compressMultiSerial(uint64_t *const states[], const uint8_t *const blocks[], size_t len);
+	
+	// Only defined if USE_X86_INTRINSICS is defined.
+	static void compressMultiAvx2(uint64_t *const states[], const uint8_t *const blocks[], size_t len);
+	
+	// Only defined if USE_X86_INTRINSICS is defined.
+	static void compressMultiAvx512(uint64_t *const states[], const uint8_t *const blocks[], size_t len);
+	
+	// Runs the given number of further PBKDF2 iterations for each of len passwords. Each password has 16 words
+	// in the array: the previous HMAC output U followed by the running exclusive-OR T, both as big-endian words.
+	typedef void (*Pbkdf2IterateFunc)(const HmacSha512Key keys[], uint64_t words[], size_t len, uint32_t iterations);
+	
+	static Pbkdf2IterateFunc selectPbkdf2Iterate();
+	
+	static void pbkdf2IterateSerial(const HmacSha512Key keys[], uint64_t words[], size_t len, uint32_t iterations);
+	
+	// Only defined if USE_X86_INTRINSICS is defined.
+	static void pbkdf2IterateAvx2(const HmacSha512Key keys[], uint64_t words[], size_t len, uint32_t iterations);
+	
+	// Only defined if USE_X86_INTRINSICS is defined.
+	static void pbkdf2IterateAvx512(const HmacSha512Key keys[], uint64_t words[], size_t len, uint32_t iterations);
+	
+	// Lets the test suite call every kernel that the CPU supports, not just the selected one.
+	friend class Sha512Test;
+	
+	
+	
+	/*---- Stateful hasher fields and methods ----*/
+	
+private:
+	uint64_t state[8];
+	uint64_t length;
+	uint8_t buffer[SHA512_BLOCK_LEN];
+	int bufferLen;
+	
+	
+public:
+	// Constructs a new SHA-512 hasher with an initially blank message. Hashers are copyable, so a copy
+	// taken after appending a common prefix is a snapshot that can be resumed any number of times.
+	Sha512();
+	
+	
+	// Constructs a SHA-512 hasher that resumes from the given midstate, which came from getMidstate().
+	// The length is the number of message bytes already compressed into the midstate,
+	// and must be a multiple of SHA512_BLOCK_LEN.
+	Sha512(const uint64_t midstate[8], uint64_t length_);
+	
+	
+	// Appends message bytes to this ongoing hasher. Whole blocks are compressed directly from the given array.
+	void append(const uint8_t *bytes, size_t len);
+	
+	
+	// If the number of bytes seen is a multiple of SHA512_BLOCK_LEN (so nothing is buffered), then this
+	// writes the compression state and the number of bytes seen, and returns true. Otherwise this
+	// returns false and leaves the outputs unchanged; a copy of the hasher serves as the snapshot instead.
+	bool getMidstate(uint64_t outState[8], uint64_t &outLength) const;
+	
+	
+	// Writes the SHA-512 hash of all the bytes seen. Doesn't change this hasher, so
+	// more bytes can be appended and getHash() can be called again afterward.
+	void getHash(uint8_t hashResult[SHA512_HASH_LEN]) const;
+	
 	
 	
 	/*---- Class constants ----*/
 	
+public:
+	static const uint64_t INITIAL_STATE[8];
+private:
 	static const uint64_t ROUND_CONSTANTS[80];
 	
 };
@@ -9,10 +9,13 @@
  */
 
 #include "TestHelper.hpp"
+#include <algorithm>
 #include <cstdio>
 #include <cstdint>
 #include <cstring>
+#include <vector>
 #include "Sha512.hpp"
+#include "Utils.hpp"
 
 
 /*---- Structures ----*/
@@ -22,6 +25,95 @@ struct TestCase {
 	const char *expectedHash;
 	const Bytes message;
 };
+struct HmacCase {
+	const bool matches;
+	const char *expectedHash;
+	const Bytes key;
+	const Bytes message;
+};
+struct Pbkdf2Case {
+	const char *expectedKey;
+	const Bytes password;
+	const Bytes salt;
+	const uint32_t iterations;
+};
+
+
+// Has access to the private kernels of Sha512, because dispatch selects only one of them for the running CPU.
+class Sha512Test final {
+	
+public:
+	
+	typedef Sha512::CompressFunc CompressFunc;
+	
+	
+	// Returns the portable kernel and the AVX2 kernel if the running CPU supports it.
+	static std::vector<CompressFunc> getCompressKernels() {
+		std::vector<CompressFunc> result;
+		result.push_back(Sha512::compressPortable);
+#ifdef USE_X86_INTRINSICS
+		if (Utils::getCpuFeatures().avx2)
+			result.push_back(Sha512::compressAvx2);
+#endif
+		return result;
+	}
+	
+	
+	// Hashes the given message by padding it and compressing every block with the given kernel only.
+	static Bytes getHashWith(CompressFunc func, const uint8_t *msg, size_t len) {
+		Bytes padded(msg, msg + len);
+		padded.push_back(0x80);
+		while (padded.size() % SHA512_BLOCK_LEN != SHA512_BLOCK_LEN - 16)
+			padded.push_back(0x00);
+		const uint64_t bitLen = static_cast<uint64_t>(len) << 3;
+		for (int i = 15; i >= 0; i--)
+			padded.push_back(i < 8 ? static_cast<uint8_t>(bitLen >> (i * 8)) : 0);
+		uint64_t state[8];
+		memcpy(state, Sha512::INITIAL_STATE, sizeof(state));
+		func(state, padded.data(), padded.size());
+		Bytes result;
+		for (int i = 0; i < SHA512_HASH_LEN; i++)
+			result.push_back(static_cast<uint8_t>(state[i >> 3] >> ((7 - (i & 7)) << 3)));
+		return result;
+	}
+	
+	
+	typedef Sha512::CompressMultiFunc CompressMultiFunc;
+	
+	
+	// Returns the portable kernel and every SIMD kernel that the running CPU supports.
+	static std::vector<CompressMultiFunc> getCompressMultiKernels() {
+		std::vector<CompressMultiFunc> result;
+		result.push_back(Sha512::compressMultiSerial);
+#ifdef USE_X86_INTRINSICS
+		const Utils::CpuFeatures &cpu = Utils::getCpuFeatures();
+		if (cpu.avx2)
+			result.push_back(Sha512::compressMultiAvx2);
+		if (cpu.avx512f)
+			result.push_back(Sha512::compressMultiAvx512);
+#endif
+		return result;
+	}
+	
+	
+	typedef Sha512::Pbkdf2IterateFunc Pbkdf2IterateFunc;
+	
+	
+	// Returns the portable kernel and every SIMD kernel that the running CPU supports.
+	static std::vector<Pbkdf2IterateFunc> getPbkdf2IterateKernels() {
+		std::vector<Pbkdf2IterateFunc> result;
+		result.push_back(Sha512::pbkdf2IterateSerial);
+#ifdef USE_X86_INTRINSICS
+		const Utils::CpuFeatures &cpu = Utils::getCpuFeatures();
+		if (cpu.avx2)
+			result.push_back(Sha512::pbkdf2IterateAvx2);
+		if (cpu.avx512f)
+			result.push_back(Sha512::pbkdf2IterateAvx512);
+#endif
+		return result;
+	}
+	
+};
 
 
 /*---- Test suite ----*/
@@ -327,7 +419,233 @@ int main(int argc, char **argv) {
 		Sha512::getHash(tc.message.data(), tc.message.size(), actualHash);
 		assert((memcmp(actualHash, expectHash.data(), SHA512_HASH_LEN) == 0) == tc.matches);
 		numTestCases++;
+		
+		// The stateful hasher must agree with the static function for every piece size
+		for (size_t pieceLen = 1; pieceLen <= tc.message.size(); pieceLen *= 3) {
+			Sha512 hasher;
+			for (size_t off = 0; off < tc.message.size(); off += pieceLen) {
+				size_t n = std::min(pieceLen, tc.message.size() - off);
+				hasher.append(&tc.message[off], n);
+			}
+			uint8_t pieceHash[SHA512_HASH_LEN] = {};
+			hasher.getHash(pieceHash);
+			assert(memcmp(pieceHash, actualHash, SHA512_HASH_LEN) == 0);
+			
+			// Finishing is non-destructive, and copies are independent snapshots
+			Sha512 copy(hasher);
+			copy.append(tc.message.data(), tc.message.size());
+			hasher.getHash(pieceHash);
+			assert(memcmp(pieceHash, actualHash, SHA512_HASH_LEN) == 0);
+
+			// Resume from an exported midstate
+			uint64_t midstate[8];
+			uint64_t midLength;
+			if (hasher.getMidstate(midstate, midLength)) {
+				Sha512 resumed(midstate, midLength);
+				resumed.getHash(pieceHash);
+				assert(memcmp(pieceHash, actualHash, SHA512_HASH_LEN) == 0);
+			}
+			numTestCases++;
+		}
 	}
+	
+	// Every single-block kernel that the CPU supports, on its own, against the known answers
+	const std::vector<Sha512Test::CompressFunc> singleKernels(Sha512Test::getCompressKernels());
+	for (size_t k = 0; k < singleKernels.size(); k++) {
+		for (unsigned int i = 0; i < ARRAY_LENGTH(cases); i++) {
+			TestCase &tc = cases[i];
+			const Bytes actualHash(Sha512Test::getHashWith(singleKernels[k], tc.message.data(), tc.message.size()));
+			assert((actualHash == hexBytes(tc.expectedHash)) == tc.matches);
+		}
+		numTestCases++;
+	}
+	
+	// Every single-block kernel versus the portable one, over several numbers of blocks per call
+	for (size_t numBlocks = 0; numBlocks <= 5; numBlocks++) {
+		uint8_t blocks[5 * SHA512_BLOCK_LEN];
+		for (size_t i = 0; i < numBlocks * SHA512_BLOCK_LEN; i++)
+			blocks[i] = static_cast<uint8_t>(i * 13 + numBlocks * 101);
+		uint64_t expectState[8];
+		for (int j = 0; j < 8; j++)
+			expectState[j] = UINT64_C(0x9E3779B97F4A7C15) * (j + numBlocks + 1);
+		uint64_t initState[8];
+		memcpy(initState, expectState, sizeof(initState));
+		singleKernels[0](expectState, blocks, numBlocks * SHA512_BLOCK_LEN);
+		for (size_t k = 1; k < singleKernels.size(); k++) {
+			uint64_t state[8];
+			memcpy(state, initState, sizeof(state));
+			singleKernels[k](state, blocks, numBlocks * SHA512_BLOCK_LEN);
+			assert(memcmp(state, expectState, sizeof(state)) == 0);
+		}
+		numTestCases++;
+	}
+	
+	// Multi-buffer hashing of every prefix count of the cases
+	for (size_t count = 0; count <= ARRAY_LENGTH(cases); count += 3) {
+		std::vector<const uint8_t*> msgs;
+		std::vector<size_t> lens;
+		std::vector<Bytes> hashes(count, Bytes(SHA512_HASH_LEN));
+		std::vector<uint8_t*> hashPtrs;
+		for (size_t i = 0; i < count; i++) {
+			msgs.push_back(cases[i].message.data());
+			lens.push_back(cases[i].message.size());
+			hashPtrs.push_back(hashes[i].data());
+		}
+		Sha512::getHashMulti(msgs.data(), lens.data(), count, hashPtrs.data());
+		for (size_t i = 0; i < count; i++)
+			assert((hashes[i] == hexBytes(cases[i].expectedHash)) == cases[i].matches);
+		numTestCases++;
+	}
+	
+	// Multi-buffer compression versus single compression, for each number of lanes,
+	// through dispatch and through every kernel that the CPU supports
+	const std::vector<Sha512Test::CompressMultiFunc> compressKernels(Sha512Test::getCompressMultiKernels());
+	for (size_t count = 0; count <= 20; count++) {
+		uint8_t blocks[20][SHA512_BLOCK_LEN];
+		uint64_t initStates[20][8];
+		uint64_t expectStates[20][8];
+		const uint8_t *blockPtrs[20];
+		for (size_t i = 0; i < count; i++) {
+			for (int j = 0; j < SHA512_BLOCK_LEN; j++)
+				blocks[i][j] = static_cast<uint8_t>(i * 31 + j * 7 + count);
+			for (int j = 0; j < 8; j++)
+				initStates[i][j] = expectStates[i][j] = UINT64_C(0x9E3779B97F4A7C15) * (i * 8 + j + 1);
+			blockPtrs[i] = blocks[i];
+			Sha512::compress(expectStates[i], blocks[i], SHA512_BLOCK_LEN);
+		}
+		for (size_t k = 0; k <= compressKernels.size(); k++) {
+			uint64_t states[20][8];
+			uint64_t *statePtrs[20];
+			for (size_t i = 0; i < count; i++) {
+				memcpy(states[i], initStates[i], sizeof(states[i]));
+				statePtrs[i] = states[i];
+			}
+			if (k == 0)
+				Sha512::compressMulti(statePtrs, blockPtrs, count);
+			else
+				compressKernels[k - 1](statePtrs, blockPtrs, count);
+			for (size_t i = 0; i < count; i++)
+				assert(memcmp(states[i], expectStates[i], sizeof(states[i])) == 0);
+			numTestCases++;
+		}
+	}
+	
+	// HMAC-SHA-512 message authentication code (RFC 4231, and BIP32 test vector 1 chain m/0H)
+	HmacCase hmacCases[] = {
+		{true, "87AA7CDEA5EF619D4FF0B4241A1D6CB02379F4E2CE4EC2787AD0B30545E17CDEDAA833B7D6B8A702038B274EAEA3F4E4BE9D914EEB61F1702E696C203A126854", hexBytes("0B0B0B0B0B0B0B0B0B0B0B0B0B0B0B0B0B0B0B0B"), asciiBytes("Hi There")},
+		{true, "164B7A7BFCF819E2E395FBE73B56E0A387BD64222E831FD610270CD7EA2505549758BF75C05A994A6D034F65F8F0E6FDCAEAB1A34D4A6B4B636E070A38BCE737", asciiBytes("Jefe"), asciiBytes("what do ya want for nothing?")},
+		{true, "FA73B0089D56A284EFB0F0756C890BE9B1B5DBDD8EE81A3655F83E33B2279D39BF3E848279A722C806B485A47E67C807B946A337BEE8942674278859E13292FB", hexBytes("AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA"), hexBytes("DDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDDD")},
+		{true, "B0BA465637458C6990E5A8C5F61D4AF7E576D97FF94B872DE76F8050361EE3DBA91CA5C11AA25EB4D679275CC5788063A5F19741120C4F2DE2ADEBEB10A298DD", hexBytes("0102030405060708090A0B0C0D0E0F10111213141516171819"), hexBytes("CDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCDCD")},
+		{true, "80B24263C7C1A3EBB71493C1DD7BE8B49B46D1F41B4AEEC1121B013783F8F3526B56D037E05F2598BD0FD2215D6A1E5295E64F73F63F0AEC8B915A985D786598", Bytes(131, 0xAA), asciiBytes("Test Using Larger Than Block-Size Key - Hash Key First")},
+		{true, "E37B6A775DC87DBAA4DFA9F96E5E3FFDDEBD71F8867289865DF5A32D20CDC944B6022CAC3C4982B10D5EEB55C3E4DE15134676FB6DE0446065C97440FA8C6A58", Bytes(131, 0xAA), asciiBytes("This is a test using a larger than block-size key and a larger than block-size data. The key needs to be hashed before being used by the HMAC algorithm.")},
+		{true, "04BFB2DD60FA8921C2A4085EC15507A921F49CDC839F27F0F280E9C1495D44B547FDACBD0F1097043B78C63C20C34EF4ED9A111D980047AD16282C7AE6236141", hexBytes("873DFF81C02F525623FD1FE5167EAC3A55A049DE3D314BB42EE227FFED37D508"), hexBytes("00E8F32E723DECF4051AEFAC8E2C93C9C5B214313817CDB01A1494B917C8436B3580000000")},
+		{false, "87AA7CDEA5EF619D4FF0B4241A1D6CB02379F4E2CE4EC2787AD0B30545E17CDEDAA833B7D6B8A702038B274EAEA3F4E4BE9D914EEB61F1702E696C203A126854", hexBytes("0B0B0B0B0B4B0B0B0B0B0B0B0B0B0B0B0B0B0B0B"), asciiBytes("Hi There")},
+		{false, "87AA7CDEA5EF619D4FF0B4241A1D6CB02379F4E2CE4EC2787AD0B30545E17CDEDAA833B7D6B8A702038B274EAEA3F4E4BE9D914EEB61F1702E696C203A126854", hexBytes("0B0B0B0B0B0B0B0B0B0B0B0B0B0B0B0B0B0B0B0B"), asciiBytes("HI There")},
+	};
+	for (unsigned int i = 0; i < ARRAY_LENGTH(hmacCases); i++) {
+		HmacCase &tc = hmacCases[i];
+		Bytes expectHash(hexBytes(tc.expectedHash));
+		uint8_t actualHash[SHA512_HASH_LEN] = {};
+		Sha512::getHmac(tc.key.data(), tc.key.size(), tc.message.data(), tc.message.size(), actualHash);
+		assert((memcmp(actualHash, expectHash.data(), SHA512_HASH_LEN) == 0) == tc.matches);
+		const HmacSha512Key key(tc.key.data(), tc.key.size());
+		for (int j = 0; j < 2; j++) {  // Key contexts are reusable
+			uint8_t keyedHash[SHA512_HASH_LEN] = {};
+			Sha512::getHmac(key, tc.message.data(), tc.message.size(), keyedHash);
+			assert((memcmp(keyedHash, expectHash.data(), SHA512_HASH_LEN) == 0) == tc.matches);
+		}
+		numTestCases++;
+	}
+	
+	// Batched HMAC under one key, for every message length that fits one block and enough messages for partial chunks
+	const HmacSha512Key hmacKey(hexBytes("873DFF81C02F525623FD1FE5167EAC3A55A049DE3D314BB42EE227FFED37D508").data(), 32);
+	for (size_t msgLen = 0; msgLen <= 111; msgLen += (msgLen == 37 ? 1 : 37)) {
+		const size_t count = 19;
+		std::vector<Bytes> messages;
+		std::vector<Bytes> macs(count, Bytes(SHA512_HASH_LEN));
+		std::vector<const uint8_t*> msgPtrs;
+		std::vector<uint8_t*> macPtrs;
+		for (size_t i = 0; i < count; i++)
+			messages.push_back(Bytes(msgLen, static_cast<uint8_t>(i * 11)));
+		for (size_t i = 0; i < count; i++) {
+			msgPtrs.push_back(messages[i].data());
+			macPtrs.push_back(macs[i].data());
+		}
+		Sha512::getHmacMulti(hmacKey, msgPtrs.data(), msgLen, count, macPtrs.data());
+		for (size_t i = 0; i < count; i++) {
+			Bytes expectMac(SHA512_HASH_LEN);
+			Sha512::getHmac(hmacKey, messages[i].data(), msgLen, expectMac.data());
+			assert(macs[i] == expectMac);
+		}
+		numTestCases++;
+	}
+	
+	// PBKDF2-HMAC-SHA-512 key derivation (the first case is the BIP39 seed of the all-"abandon" mnemonic)
+	Pbkdf2Case pbkdf2Cases[] = {
+		{"C55257C360C07C72029AEBC1B53C05ED0362ADA38EAD3E3E9EFA3708E53495531F09A6987599D18264C1E1C92F2CF141630C7A3C4AB7C81B2F001698E7463B04", asciiBytes("abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon abandon about"), asciiBytes("mnemonicTREZOR"), 2048},
+		{"867F70CF1ADE02CFF3752599A3A53DC4AF34C7A669815AE5D513554E1C8CF252C02D470A285A0501BAD999BFE943C08F050235D7D68B1DA55E63F73B60A57FCE", asciiBytes("password"), asciiBytes("salt"), 1},
+		{"E1D9C16AA681708A45F5C7C4E215CEB66E011A2E9F0040713F18AEFDB866D53CF76CAB2868A39B9F7840EDCE4FEF5A82BE67335C77A6068E04112754F27CCF4E", asciiBytes("password"), asciiBytes("salt"), 2},
+		{"D197B1B33DB0143E018B12F3D1D1479E6CDEBDCC97C5C0F87F6902E072F457B5143F30602641B3D55CD335988CB36B84376060ECD532E039B742A239434AF2D5", asciiBytes("password"), asciiBytes("salt"), 4096},
+		{"8C0511F4C6E597C6AC6315D8F0362E225F3C501495BA23B868C005174DC4EE71115B59F9E60CD9532FA33E0F75AEFE30225C583A186CD82BD4DAEA9724A3D3B804F75BDD41494FA324CAB24BCC680FB3B96A30CF5D21FAC3C2875913919F3399B1D9CE7E", asciiBytes("passwordPASSWORDpassword"), asciiBytes("saltSALTsaltSALTsaltSALTsaltSALTsalt"), 4096},
+		{"BA78A2C18FE1F3CFFFABA0F93CCF85FC342EDF2C", Bytes(), Bytes(), 3},
+		{"D9FEE74E516ABD0ECD5489D48B90D6F5D865323C55C4440BA77B896AFA21EA59CD0EFD782CA6C3F7DE3491D330AC61E5D0EED630FD0CE1276F10F99D4BC43E6C3CD397D24F80328FCFA6C3AEE60FC42743B899535C71D979D05F5B92AC29602AE6A96CBDE98FDEA01A8822E4E9365D8F40B791877C57AA0C15D9B8A363F561437FED", Bytes(200, 'K'), Bytes(300, 'S'), 5},
+	};
+	for (unsigned int i = 0; i < ARRAY_LENGTH(pbkdf2Cases); i++) {
+		Pbkdf2Case &tc = pbkdf2Cases[i];
+		Bytes expectKey(hexBytes(tc.expectedKey));
+		Bytes actualKey(expectKey.size());
+		Sha512::getPbkdf2(tc.password.data(), tc.password.size(), tc.salt.data(), tc.salt.size(), tc.iterations, actualKey.data(), actualKey.size());
+		assert(actualKey == expectKey);
+		numTestCases++;
+	}
+	
+	// Batched PBKDF2, with enough passwords for whole and partial groups of SIMD lanes
+	for (size_t count = 0; count <= 9; count++) {
+		const Bytes salt(asciiBytes("mnemonicTREZOR"));
+		const size_t outLen = 70;
+		std::vector<Bytes> passwords;
+		std::vector<Bytes> keys(count, Bytes(outLen));
+		std::vector<const uint8_t*> passwordPtrs;
+		std::vector<size_t> passwordLens;
+		std::vector<uint8_t*> keyPtrs;
+		for (size_t i = 0; i < count; i++)
+			passwords.push_back(Bytes(i * 13, static_cast<uint8_t>('a' + i)));
+		for (size_t i = 0; i < count; i++) {
+			passwordPtrs.push_back(passwords[i].data());
+			passwordLens.push_back(passwords[i].size());
+			keyPtrs.push_back(keys[i].data());
+		}
+		Sha512::getPbkdf2Multi(passwordPtrs.data(), passwordLens.data(), count, salt.data(), salt.size(), 7, keyPtrs.data(), outLen);
+		for (size_t i = 0; i < count; i++) {
+			Bytes expectKey(outLen);
+			Sha512::getPbkdf2(passwords[i].data(), passwords[i].size(), salt.data(), salt.size(), 7, expectKey.data(), outLen);
+			assert(keys[i] == expectKey);
+		}
+		numTestCases++;
+	}
+	
+	// Every PBKDF2 iteration kernel that the CPU supports versus the portable one,
+	// with enough passwords for whole and partial groups of SIMD lanes
+	const std::vector<Sha512Test::Pbkdf2IterateFunc> pbkdf2Kernels(Sha512Test::getPbkdf2IterateKernels());
+	for (size_t count = 0; count <= 17; count++) {
+		std::vector<HmacSha512Key> keys;
+		std::vector<uint64_t> initWords(count * 16);
+		for (size_t i = 0; i < count; i++) {
+			const Bytes password(i * 11, static_cast<uint8_t>('A' + i));
+			keys.push_back(HmacSha512Key(password.data(), password.size()));
+			for (int j = 0; j < 16; j++)
+				initWords[i * 16 + j] = UINT64_C(0x9E3779B97F4A7C15) * (i * 16 + j + count + 1);
+		}
+		std::vector<uint64_t> expectWords(initWords);
+		pbkdf2Kernels[0](keys.data(), expectWords.data(), count, 5);
+		for (size_t k = 1; k < pbkdf2Kernels.size(); k++) {
+			std::vector<uint64_t> words(initWords);
+			pbkdf2Kernels[k](keys.data(), words.data(), count, 5);
+			assert(words == expectWords);
+			numTestCases++;
+		}
+	}
+	
 	printf("All %d test cases passed\n", numTestCases);
 	return 0;
 }
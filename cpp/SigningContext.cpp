@@ -0,0 +1,44 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include <cassert>
+#include "SigningContext.hpp"
+#include "CurvePoint.hpp"
+#include "Ecdsa.hpp"
+#include "Sha256.hpp"
+
+
+// Returns the HMAC key context for the given private key in 32-byte big-endian form.
+static HmacSha256Key getHmacKey(const Uint256 &privKey) {
+	uint8_t privkeyBytes[32];
+	privKey.getBigEndianBytes(privkeyBytes);
+	return HmacSha256Key(privkeyBytes, sizeof(privkeyBytes));
+}
+
+
+SigningContext::SigningContext(const Uint256 &privKey) :
+		privateKey(privKey),
+		hmacKey(getHmacKey(privKey)) {
+	assert((Uint256::ZERO < privKey) & (privKey < CurvePoint::ORDER));
+}
+
+
+bool SigningContext::sign(const Sha256Hash &msgHash, Uint256 &outR, Uint256 &outS) const {
+	return Ecdsa::sign(privateKey, msgHash, getNonce(msgHash), outR, outS);
+}
+
+
+bool SigningContext::signBatch(const Sha256Hash msgHashes[], size_t len, Uint256 outR[], Uint256 outS[]) const {
+	return Ecdsa::signBatchWithHmacNonce(privateKey, hmacKey, msgHashes, len, outR, outS);
+}
+
+
+Uint256 SigningContext::getNonce(const Sha256Hash &msgHash) const {
+	const Sha256Hash hmac(Sha256::getHmac(hmacKey, msgHash.value, SHA256_HASH_LEN));
+	return Uint256(hmac.value);
+}
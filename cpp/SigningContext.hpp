@@ -0,0 +1,61 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "Sha256.hpp"
+#include "Sha256Hash.hpp"
+#include "Uint256.hpp"
+
+
+/* 
+ * Signs many messages with one private key, producing the same signatures as Ecdsa::signWithHmacNonce().
+ * The HMAC key states derived from the private key are computed once at construction, and the
+ * nonce points come from the shared precomputed tables of multiples of the base point.
+ * Instances of this class are immutable, and hold secret data.
+ */
+class SigningContext final {
+	
+	/*---- Fields ----*/
+	
+private:
+	Uint256 privateKey;
+	HmacSha256Key hmacKey;  // Keyed by the private key
+	
+	
+	
+	/*---- Constructors ----*/
+public:
+	
+	// Constructs a context for the given private key, which must be in the range [1, CurvePoint::ORDER).
+	// Constant-time with respect to the value.
+	explicit SigningContext(const Uint256 &privKey);
+	
+	
+	
+	/*---- Methods ----*/
+	
+	// Signs the given message hash, giving the same result as Ecdsa::signWithHmacNonce() with this context's
+	// private key. Returns true iff signing is successful (with overwhelming probability).
+	bool sign(const Sha256Hash &msgHash, Uint256 &outR, Uint256 &outS) const;
+	
+	
+	// Signs each of the given len message hashes together using Ecdsa::signBatchWithHmacNonce() with the cached
+	// HMAC key context, writing to outR[i] and outS[i] iff signing msgHashes[i] is successful.
+	// Returns true iff all of them are successful.
+	bool signBatch(const Sha256Hash msgHashes[], size_t len, Uint256 outR[], Uint256 outS[]) const;
+	
+	
+private:
+	
+	// Computes the nonce that Ecdsa::signWithHmacNonce() would use for the given message hash.
+	Uint256 getNonce(const Sha256Hash &msgHash) const;
+	
+};
@@ -0,0 +1,88 @@
+/* 
+ * A runnable main program that tests the functionality of class SigningContext.
+ * 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include "TestHelper.hpp"
+#include <cstdio>
+#include "CurvePoint.hpp"
+#include "Ecdsa.hpp"
+#include "Sha256.hpp"
+#include "Sha256Hash.hpp"
+#include "SigningContext.hpp"
+#include "Uint256.hpp"
+
+
+// Global variables
+static int numTestCases = 0;
+
+static const char *PRIVATE_KEYS[] = {
+	"0000000000000000000000000000000000000000000000000000000000000001",
+	"C1014E82EEE3CD4AECBB43029CD0C4A38F57108887BFD39D4196EFB92A1A81C5",
+	"5E241A7524A58A8D69C0CD2566EF2CD4CA77910C7AC7825D9D7FB7670BA3E0FC",
+	"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364140",
+};
+
+
+static std::vector<Sha256Hash> makeHashes(size_t count) {
+	std::vector<Sha256Hash> result;
+	for (size_t i = 0; i < count; i++) {
+		uint8_t msg[2] = {static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8)};
+		result.push_back(Sha256::getHash(msg, sizeof(msg)));
+	}
+	return result;
+}
+
+
+/*---- Test cases ----*/
+
+static void testSign() {
+	const std::vector<Sha256Hash> hashes(makeHashes(5));
+	for (unsigned int i = 0; i < ARRAY_LENGTH(PRIVATE_KEYS); i++) {
+		Uint256 privateKey(PRIVATE_KEYS[i]);
+		const SigningContext ctx(privateKey);
+		for (const Sha256Hash &msgHash : hashes) {
+			Uint256 expectR, expectS, actualR, actualS;
+			assert(Ecdsa::signWithHmacNonce(privateKey, msgHash, expectR, expectS));
+			assert(ctx.sign(msgHash, actualR, actualS));
+			assert(actualR == expectR && actualS == expectS);
+			numTestCases++;
+		}
+	}
+}
+
+
+static void testSignBatch() {
+	const size_t lengths[] = {0, 1, 3, 40};
+	for (unsigned int i = 0; i < ARRAY_LENGTH(PRIVATE_KEYS); i++) {
+		Uint256 privateKey(PRIVATE_KEYS[i]);
+		const SigningContext ctx(privateKey);
+		for (unsigned int j = 0; j < ARRAY_LENGTH(lengths); j++) {
+			size_t len = lengths[j];
+			const std::vector<Sha256Hash> hashes(makeHashes(len));
+			std::vector<Uint256> rs(len), ss(len);
+			assert(ctx.signBatch(hashes.data(), len, rs.data(), ss.data()));
+			for (size_t k = 0; k < len; k++) {
+				Uint256 r, s;
+				assert(ctx.sign(hashes[k], r, s));
+				assert(rs[k] == r && ss[k] == s);
+			}
+			numTestCases++;
+		}
+	}
+}
+
+
+/*---- Main runner ----*/
+
+int main(int argc, char **argv) {
+	testSign();
+	testSignBatch();
+	printf("All %d test cases passed\n", numTestCases);
+	return 0;
+}
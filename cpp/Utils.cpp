@@ -6,9 +6,14 @@
  * https://github.com/nayuki/Bitcoin-Cryptography-Library
  */
 
+#include <cstdint>
 #include <cstring>
 #include "Utils.hpp"
 
+#ifdef USE_X86_INTRINSICS
+	#include <cpuid.h>
+#endif
+
 
 int Utils::parseHexDigit(int ch) {
 	if (ch >= '0' && ch <= '9')
@@ -28,4 +33,41 @@ void Utils::copyBytes(void *dest, const void *src, size_t count) {
 }
 
 
+const Utils::CpuFeatures &Utils::getCpuFeatures() {
+	static const CpuFeatures features = detectCpuFeatures();  // Thread-safe initialization since C++11
+	return features;
+}
+
+
+Utils::CpuFeatures Utils::detectCpuFeatures() {
+	CpuFeatures result = {false, false, false, false, false};
+#ifdef USE_X86_INTRINSICS
+	unsigned int eax, ebx, ecx, edx;
+	if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0)
+		return result;
+	result.ssse3 = ((ecx >>  9) & 1) != 0;
+	result.sse41 = ((ecx >> 19) & 1) != 0;
+	
+	// AVX2 also needs the operating system to save the YMM registers (XCR0 bits 1 and 2),
+	// and AVX-512 additionally the opmask and ZMM registers (XCR0 bits 5 to 7)
+	bool osSavesYmm = false;
+	bool osSavesZmm = false;
+	if (((ecx >> 27) & 1) != 0) {  // OSXSAVE
+		uint32_t xcr0Low, xcr0High;
+		__asm__("xgetbv" : "=a"(xcr0Low), "=d"(xcr0High) : "c"(0));
+		osSavesYmm = (xcr0Low & 0x06) == 0x06;
+		osSavesZmm = (xcr0Low & 0xE6) == 0xE6;
+	}
+	
+	if (__get_cpuid_max(0, nullptr) >= 7) {
+		__cpuid_count(7, 0, eax, ebx, ecx, edx);
+		result.avx2 = osSavesYmm && ((ebx >> 5) & 1) != 0;
+		result.avx512f = osSavesZmm && ((ebx >> 16) & 1) != 0;
+		result.sha = ((ebx >> 29) & 1) != 0;
+	}
+#endif
+	return result;
+}
+
+
 const char *Utils::HEX_DIGITS = "0123456789abcdef";
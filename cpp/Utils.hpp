@@ -8,6 +8,23 @@
 
 #pragma once
 
+#include <cstddef>
+
+
+// Hardware-specific code paths (selected at run time) are compiled only on x86 with a GCC-compatible
+// compiler. Defining DISABLE_INTRINSICS when compiling forces the portable code paths everywhere.
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && !defined(DISABLE_INTRINSICS)
+	#define USE_X86_INTRINSICS
+#endif
+
+// Marks a round helper that is generic over plain words and GCC vector types. With the hardware-specific
+// paths, it is always inlined so that its vector code is generated under each calling kernel's target attribute.
+#ifdef USE_X86_INTRINSICS
+	#define INLINE_LANES  inline __attribute__((always_inline))
+#else
+	#define INLINE_LANES  inline
+#endif
+
 
 /* 
  * Miscellaneous utilities used in a variety of places.
@@ -33,7 +50,24 @@ public:
 	static void copyBytes(void *dest, const void *src, size_t count);
 	
 	
+	// The instruction set extensions of the running CPU that some functions use for acceleration.
+	// Every flag is false if USE_X86_INTRINSICS is not defined.
+	struct CpuFeatures final {
+		bool ssse3;
+		bool sse41;
+		bool avx2;
+		bool avx512f;
+		bool sha;
+	};
+	
+	// Returns the features of the running CPU, which are detected once on the first call.
+	static const CpuFeatures &getCpuFeatures();
+	
+	
 private:
+	
+	static CpuFeatures detectCpuFeatures();
+	
 	Utils();
 	
 };
@@ -0,0 +1,113 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include <cassert>
+#include <deque>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include "VerifyQueue.hpp"
+#include "Ecdsa.hpp"
+
+
+// A double-ended queue of job indexes. The owning worker takes from the back,
+// while other workers steal from the front, so that they rarely contend.
+struct VerifyQueue::WorkerDeque final {
+	std::mutex lock;
+	std::deque<size_t> indexes;
+	
+	// Removes an index from the given end and stores it in the output. Returns false iff empty.
+	bool pop(bool fromBack, size_t &out) {
+		std::lock_guard<std::mutex> guard(lock);
+		if (indexes.empty())
+			return false;
+		if (fromBack) {
+			out = indexes.back();
+			indexes.pop_back();
+		} else {
+			out = indexes.front();
+			indexes.pop_front();
+		}
+		return true;
+	}
+};
+
+
+VerifyQueue::Job::Job(const CurvePoint &pubKey, const Sha256Hash &hash, const Uint256 &r_, const Uint256 &s_) :
+	publicKey(pubKey), msgHash(hash), r(r_), s(s_) {}
+
+
+VerifyQueue::VerifyQueue(unsigned int threads) :
+		numThreads(threads) {
+	if (numThreads == 0)
+		numThreads = std::thread::hardware_concurrency();
+	if (numThreads == 0)  // Unknown
+		numThreads = 1;
+}
+
+
+void VerifyQueue::add(const CurvePoint &publicKey, const Sha256Hash &msgHash, const Uint256 &r, const Uint256 &s) {
+	jobs.push_back(Job(publicKey, msgHash, r, s));
+}
+
+
+size_t VerifyQueue::size() const {
+	return jobs.size();
+}
+
+
+bool VerifyQueue::verifyAll() {
+	size_t numJobs = jobs.size();
+	unsigned int n = numThreads;
+	if (n > numJobs)
+		n = static_cast<unsigned int>(numJobs);
+	if (n == 0)
+		return true;
+	
+	// Give each worker a contiguous range of jobs
+	std::vector<WorkerDeque> deques(n);
+	for (unsigned int i = 0; i < n; i++) {
+		size_t start = numJobs * i / n;
+		size_t end = numJobs * (i + 1) / n;
+		for (size_t j = start; j < end; j++)
+			deques[i].indexes.push_back(j);
+	}
+	
+	// The calling thread acts as worker 0. If a thread can't be started, then spawning stops,
+	// and the jobs of the missing workers get stolen, because every worker steals from every deque.
+	std::atomic<bool> failed(false);
+	std::vector<std::thread> threads;
+	threads.reserve(n - 1);  // So that push_back() can't throw while holding a joinable thread
+	try {
+		for (unsigned int i = 1; i < n; i++)
+			threads.push_back(std::thread(workerLoop, std::cref(jobs), std::ref(deques), i, std::ref(failed)));
+	} catch (const std::system_error &) {}
+	workerLoop(jobs, deques, 0, failed);
+	for (std::thread &th : threads)
+		th.join();
+	
+	jobs.clear();
+	return !failed.load();
+}
+
+
+void VerifyQueue::workerLoop(const std::vector<Job> &jobs, std::vector<WorkerDeque> &deques, unsigned int self, std::atomic<bool> &failed) {
+	unsigned int n = static_cast<unsigned int>(deques.size());
+	assert(self < n);
+	while (!failed.load(std::memory_order_relaxed)) {
+		size_t index;
+		bool found = deques[self].pop(true, index);
+		for (unsigned int i = 1; !found && i < n; i++)  // Steal, starting from the next worker
+			found = deques[(self + i) % n].pop(false, index);
+		if (!found)
+			break;  // All deques are empty
+		const Job &job = jobs[index];
+		if (!Ecdsa::verify(job.publicKey, job.msgHash, job.r, job.s))
+			failed.store(true, std::memory_order_relaxed);
+	}
+}
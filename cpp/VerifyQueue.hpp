@@ -0,0 +1,81 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+#include "CurvePoint.hpp"
+#include "Sha256Hash.hpp"
+#include "Uint256.hpp"
+
+
+/* 
+ * Collects ECDSA signature verification jobs and checks them on several worker threads.
+ * Each worker owns a deque of jobs, and steals from the front of the other workers' deques
+ * when its own deque runs empty. The combined result is true iff every job is valid, and
+ * all workers stop early as soon as any job fails. Instances are not thread-safe themselves.
+ */
+class VerifyQueue final {
+	
+	/*---- Helper structure ----*/
+	
+private:
+	struct Job final {
+		CurvePoint publicKey;
+		Sha256Hash msgHash;
+		Uint256 r;
+		Uint256 s;
+		
+		Job(const CurvePoint &pubKey, const Sha256Hash &hash, const Uint256 &r_, const Uint256 &s_);
+	};
+	
+	struct WorkerDeque;  // Defined in the implementation file
+	
+	
+	
+	/*---- Fields ----*/
+	
+	unsigned int numThreads;
+	std::vector<Job> jobs;
+	
+	
+	
+	/*---- Constructors ----*/
+	
+public:
+	
+	// Constructs an empty queue that will use the given number of threads (including the caller's thread)
+	// to verify jobs. A value of 0 means to use the number of hardware threads reported by the system.
+	explicit VerifyQueue(unsigned int threads=0);
+	
+	
+	
+	/*---- Methods ----*/
+	
+	// Adds a job to check whether the given signature, message, and public key are valid together,
+	// with the same semantics as Ecdsa::verify(). The arguments are copied.
+	void add(const CurvePoint &publicKey, const Sha256Hash &msgHash, const Uint256 &r, const Uint256 &s);
+	
+	
+	// Returns the number of jobs currently waiting in this queue.
+	size_t size() const;
+	
+	
+	// Verifies all the jobs added so far, and removes them from this queue. Returns true iff every
+	// job is valid (an empty queue is trivially valid). Blocks until all worker threads have finished.
+	bool verifyAll();
+	
+	
+private:
+	
+	// Runs on each worker thread, claiming jobs from the given deque first and then stealing from the others.
+	static void workerLoop(const std::vector<Job> &jobs, std::vector<WorkerDeque> &deques, unsigned int self, std::atomic<bool> &failed);
+	
+};
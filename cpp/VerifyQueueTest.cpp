@@ -0,0 +1,115 @@
+/* 
+ * A runnable main program that tests the functionality of class VerifyQueue.
+ * 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include "TestHelper.hpp"
+#include <cstdio>
+#include "CurvePoint.hpp"
+#include "Ecdsa.hpp"
+#include "Sha256.hpp"
+#include "Sha256Hash.hpp"
+#include "Uint256.hpp"
+#include "VerifyQueue.hpp"
+
+
+/*---- Structures ----*/
+
+struct SignedMessage {
+	CurvePoint publicKey;
+	Sha256Hash msgHash;
+	Uint256 r;
+	Uint256 s;
+};
+
+
+// Global variables
+static int numTestCases = 0;
+static std::vector<SignedMessage> messages;
+
+
+/*---- Test cases ----*/
+
+static void makeMessages() {
+	const char *privateKeys[] = {
+		"C1014E82EEE3CD4AECBB43029CD0C4A38F57108887BFD39D4196EFB92A1A81C5",
+		"5E241A7524A58A8D69C0CD2566EF2CD4CA77910C7AC7825D9D7FB7670BA3E0FC",
+		"0F646E93FF951313A389E962A3ED77BD8E2C76C37355707BB3462CBC82E2E1A2",
+		"4651166DACF7C21B51BFB92C9E7954D2263ECD70D91528CFC08249408B2F0C11",
+		"3908E4A6FBEB9ABDDF51D0F339EC78061210FA841DF976448C053A7AB96C7EA2",
+		"801409A4F2A0A4F1FDBA2233E3E62981E67BBC56CB1A791E5824D20F00FEFF91",
+		"0000000000000000000000000000000000000000000000000000000000000001",
+	};
+	for (unsigned int i = 0; i < ARRAY_LENGTH(privateKeys); i++) {
+		Uint256 privateKey(privateKeys[i]);
+		uint8_t msg[1] = {static_cast<uint8_t>(i)};
+		const Sha256Hash msgHash(Sha256::getHash(msg, sizeof(msg)));
+		Uint256 r, s;
+		assert(Ecdsa::signWithHmacNonce(privateKey, msgHash, r, s));
+		messages.push_back(SignedMessage{CurvePoint::privateExponentToPublicPoint(privateKey), msgHash, r, s});
+	}
+}
+
+
+static void testAllValid() {
+	for (unsigned int threads = 0; threads <= 4; threads++) {
+		VerifyQueue queue(threads);
+		for (const SignedMessage &m : messages)
+			queue.add(m.publicKey, m.msgHash, m.r, m.s);
+		assert(queue.size() == messages.size());
+		assert(queue.verifyAll());
+		assert(queue.size() == 0);
+		numTestCases++;
+	}
+}
+
+
+static void testOneInvalid() {
+	for (unsigned int threads = 1; threads <= 4; threads++) {
+		for (size_t bad = 0; bad < messages.size(); bad++) {
+			VerifyQueue queue(threads);
+			for (size_t i = 0; i < messages.size(); i++) {
+				const SignedMessage &m = messages[i];
+				const SignedMessage &other = messages[(i + 1) % messages.size()];
+				if (i == bad)  // Signature belongs to a different message
+					queue.add(m.publicKey, other.msgHash, m.r, m.s);
+				else
+					queue.add(m.publicKey, m.msgHash, m.r, m.s);
+			}
+			assert(!queue.verifyAll());
+			assert(queue.size() == 0);
+			numTestCases++;
+		}
+	}
+}
+
+
+static void testEmptyAndReuse() {
+	VerifyQueue queue(3);
+	assert(queue.verifyAll());
+	numTestCases++;
+	
+	const SignedMessage &m = messages[0];
+	queue.add(m.publicKey, m.msgHash, m.s, m.r);  // Swapped
+	assert(!queue.verifyAll());
+	queue.add(m.publicKey, m.msgHash, m.r, m.s);
+	assert(queue.verifyAll());
+	numTestCases += 2;
+}
+
+
+/*---- Main runner ----*/
+
+int main(int argc, char **argv) {
+	makeMessages();
+	testAllValid();
+	testOneInvalid();
+	testEmptyAndReuse();
+	printf("All %d test cases passed\n", numTestCases);
+	return 0;
+}